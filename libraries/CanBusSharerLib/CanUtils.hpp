@@ -39,6 +39,16 @@ inline std::string msgToStr(std::uint16_t cobId, std::size_t len, const std::uin
 inline std::string msgToStr(const can_message & msg)
 { return msgToStr(msg.id & 0x7F, msg.id & 0xFF80, msg.len, msg.data); }
 
+/**
+ * @ingroup CanBusSharerLib
+ * @brief Worst-case length (bits) of a standard CAN frame, including stuff bits.
+ *
+ * Accounts for the 44-bit base frame and the 3-bit intermission field, see
+ * https://w.wiki/GDt.
+ */
+inline unsigned int getFrameLength(std::size_t len)
+{ return 8 * len + 44 + (34 + 8 * len - 1) / 4 + 3; }
+
 /**
  * @ingroup CanBusSharerLib
  * @brief Obtain a fixed-point representation given a float value.
@@ -17,6 +17,19 @@ namespace roboticslab
  * @brief Common interfaces and utilities for a network of CAN nodes.
  */
 
+/**
+ * @ingroup CanBusSharerLib
+ * @brief Worst-case description of periodic traffic a CAN node is involved in.
+ */
+struct CyclicFrame
+{
+    unsigned int cobId;     ///< COB-ID of the frame.
+    unsigned int len;       ///< Payload length (bytes).
+    double rate;            ///< Worst-case number of frames per SYNC cycle, typical load if unbounded.
+    bool relaxed;           ///< Whether it is already sent on SYNC and carries slow-changing data that may be sent less often.
+    int priority;           ///< Arbitration class (lower values are more critical), negative if the COB-ID is fixed.
+};
+
 /**
  * @ingroup CanBusSharerLib
  * @brief Abstract base for a CAN bus sharer.
@@ -34,12 +47,44 @@ public:
     virtual std::vector<unsigned int> getAdditionalIds()
     { return {}; }
 
+    //! Whether this node implements CANopen services (NMT, heartbeat, SDO server, EMCY producer).
+    virtual bool isCanOpenNode()
+    { return false; }
+
+    //! Retrieve COB-IDs of PDOs this node transmits once per SYNC cycle, if any.
+    virtual std::vector<unsigned int> getSyncPdoIds()
+    { return {}; }
+
+    //! Describe periodic frames sent or received by this node, if any.
+    virtual std::vector<CyclicFrame> getCyclicFrames()
+    { return {}; }
+
+    //! Send a relaxed frame once every @p divisor SYNC cycles, applies on initialization.
+    virtual bool setCyclicDivisor(unsigned int /*cobId*/, unsigned int /*divisor*/)
+    { return false; }
+
+    //! Replace the COB-ID of a frame, applies on initialization.
+    virtual bool remapCobId(unsigned int /*cobId*/, unsigned int /*newCobId*/)
+    { return false; }
+
     //! Perform CAN node initialization.
     virtual bool initialize() = 0;
 
+    //! Complete CAN node initialization if it was deferred until the bus master starts all nodes at once.
+    virtual bool start()
+    { return true; }
+
     //! Finalize CAN node communications.
     virtual bool finalize() = 0;
 
+    //! Notify that the node has missed its heartbeat deadline.
+    virtual void notifyHeartbeatLost()
+    { }
+
+    //! Notify that the node has announced a boot-up.
+    virtual void notifyBootUp()
+    { }
+
     //! Pass a handle to a CAN sender delegate instance.
     virtual bool registerSender(CanSenderDelegate * sender) = 0;
 
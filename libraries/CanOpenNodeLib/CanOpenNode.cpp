@@ -2,11 +2,15 @@
 
 #include "CanOpenNode.hpp"
 
+#include <ColorDebug.h>
+
 using namespace roboticslab;
 
 CanOpenNode::CanOpenNode(unsigned int id, double sdoTimeout, double stateTimeout, CanSenderDelegate * sender)
     : _id(id),
+      _sdoTimeout(sdoTimeout),
       _sdo(new SdoClient(_id, 0x600, 0x580, sdoTimeout, sender)),
+      _sdoPool(new SdoChannelPool(_sdo)),
       _rpdo1(new ReceivePdo(_id, 0x200, 1, _sdo, sender)),
       _rpdo2(new ReceivePdo(_id, 0x300, 2, _sdo, sender)),
       _rpdo3(new ReceivePdo(_id, 0x400, 3, _sdo, sender)),
@@ -36,12 +40,13 @@ CanOpenNode::~CanOpenNode()
     delete _tpdo3;
     delete _tpdo4;
 
+    delete _sdoPool;
     delete _sdo;
 }
 
 void CanOpenNode::configureSender(CanSenderDelegate * sender)
 {
-    _sdo->configureSender(sender);
+    _sdoPool->configureSender(sender);
     _rpdo1->configureSender(sender);
     _rpdo2->configureSender(sender);
     _rpdo3->configureSender(sender);
@@ -49,27 +54,61 @@ void CanOpenNode::configureSender(CanSenderDelegate * sender)
     _nmt->configureSender(sender);
 }
 
+void CanOpenNode::addSdoChannel(std::uint16_t cobRx, std::uint16_t cobTx)
+{
+    auto * sdo = new SdoClient(_id, cobRx, cobTx, _sdoTimeout);
+    sdo->configureSender(_sdo->getSender());
+    _sdoPool->add(sdo);
+}
+
+bool CanOpenNode::configureSdoChannels()
+{
+    const auto channels = _sdoPool->getChannels();
+
+    for (auto i = 1u; i < channels.size(); i++)
+    {
+        SdoClient * sdo = channels[i];
+        const std::uint16_t index = 0x1200 + i; // SDO server parameter
+
+        _sdoPool->setEnabled(sdo, false);
+
+        // CiA 301: COB-IDs may not be changed while the channel is valid, set bit 31 first
+        if (!_sdo->download<std::uint32_t>("COB-ID client to server", sdo->getCobIdRx() | 0x80000000, index, 0x01)
+            || !_sdo->download<std::uint32_t>("COB-ID server to client", sdo->getCobIdTx(), index, 0x02)
+            || !_sdo->download<std::uint32_t>("COB-ID client to server", sdo->getCobIdRx(), index, 0x01))
+        {
+            CD_ERROR("Unable to configure SDO channel %d (canId: %d).\n", i, _id);
+            return false;
+        }
+
+        _sdoPool->setEnabled(sdo, true);
+    }
+
+    return true;
+}
+
 bool CanOpenNode::notifyMessage(const can_message & message)
 {
+    // COB-IDs of TPDOs may have been reassigned, see PdoProtocol::setCobId()
+    for (auto * tpdo : {_tpdo1, _tpdo2, _tpdo3, _tpdo4})
+    {
+        if (tpdo->getCobId() == message.id)
+        {
+            return tpdo->accept(message.data, message.len);
+        }
+    }
+
     const std::uint16_t op = message.id - _id;
 
     switch (op)
     {
     case 0x80:
         return _emcy->accept(message.data);
-    case 0x180:
-        return _tpdo1->accept(message.data, message.len);
-    case 0x280:
-        return _tpdo2->accept(message.data, message.len);
-    case 0x380:
-        return _tpdo3->accept(message.data, message.len);
-    case 0x480:
-        return _tpdo4->accept(message.data, message.len);
     case 0x580:
         return _sdo->notify(message.data);
     case 0x700:
         return _nmt->accept(message.data);
     default:
-        return false;
+        return _sdoPool->notify(message.id, message.data);
     }
 }
@@ -9,6 +9,7 @@
 #include "CanMessageNotifier.hpp"
 #include "CanSenderDelegate.hpp"
 #include "SdoClient.hpp"
+#include "SdoChannelPool.hpp"
 #include "PdoProtocol.hpp"
 #include "EmcyConsumer.hpp"
 #include "NmtProtocol.hpp"
@@ -57,10 +58,29 @@ public:
     unsigned int getId() const
     { return _id; }
 
-    //! Retrieve handle of SDO client instance.
+    //! Retrieve handle of SDO client instance (default channel).
     SdoClient * sdo() const
     { return _sdo; }
 
+    //! Retrieve handle of the pool of SDO client channels.
+    SdoChannelPool * sdoPool() const
+    { return _sdoPool; }
+
+    /**
+     * @brief Register an additional SDO client channel.
+     *
+     * COB-IDs are obtained by adding the node id to the provided base values,
+     * hence the latter should leave the lowest seven bits clear. The channel
+     * is not available until @ref configureSdoChannels succeeds.
+     *
+     * @param cobRx Base COB-ID of SDO packages received by the drive.
+     * @param cobTx Base COB-ID of SDO packages sent by the drive.
+     */
+    void addSdoChannel(std::uint16_t cobRx, std::uint16_t cobTx);
+
+    //! Configure server parameters (1201h+) of additional SDO channels on the drive.
+    bool configureSdoChannels();
+
     //! Retrieve handle of RPDO1 instance.
     ReceivePdo * rpdo1() const
     { return _rpdo1; }
@@ -109,8 +129,10 @@ public:
 
 private:
     unsigned int _id;
+    double _sdoTimeout;
 
     SdoClient * _sdo;
+    SdoChannelPool * _sdoPool;
 
     ReceivePdo * _rpdo1;
     ReceivePdo * _rpdo2;
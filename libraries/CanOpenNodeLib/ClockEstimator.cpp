@@ -0,0 +1,145 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "ClockEstimator.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+ClockEstimator::ClockEstimator(unsigned int window, double wrap)
+    : window(std::max(window, 2u)), next(0), wrap(wrap), wrapOffset(0.0), lastNodeTime(0.0)
+{ }
+
+void ClockEstimator::addSample(double hostTime, double nodeTime)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (wrap > 0.0 && !samples.empty() && nodeTime + wrapOffset < lastNodeTime - wrap / 2)
+    {
+        wrapOffset += wrap;
+    }
+
+    lastNodeTime = nodeTime + wrapOffset;
+
+    if (samples.size() < window)
+    {
+        samples.emplace_back(lastNodeTime, hostTime);
+    }
+    else
+    {
+        samples[next] = {lastNodeTime, hostTime};
+    }
+
+    next = (next + 1) % window;
+}
+
+bool ClockEstimator::isReady() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples.size() >= 2;
+}
+
+double ClockEstimator::toHostTime(double nodeTime) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (samples.empty())
+    {
+        return nodeTime;
+    }
+
+    Fit f = fit();
+    return f.y0 + f.slope * (unwrap(nodeTime) - f.x0);
+}
+
+double ClockEstimator::getOffset() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    Fit f = fit();
+    return f.y0 + f.slope * (lastNodeTime - f.x0) - lastNodeTime;
+}
+
+double ClockEstimator::getDrift() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples.empty() ? 0.0 : fit().slope - 1.0;
+}
+
+double ClockEstimator::getError() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples.empty() ? 0.0 : fit().error;
+}
+
+unsigned int ClockEstimator::getSamples() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples.size();
+}
+
+void ClockEstimator::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    samples.clear();
+    next = 0;
+    wrapOffset = lastNodeTime = 0.0;
+}
+
+double ClockEstimator::unwrap(double nodeTime) const
+{
+    double value = nodeTime + wrapOffset;
+
+    if (wrap > 0.0)
+    {
+        if (value < lastNodeTime - wrap / 2)
+        {
+            value += wrap;
+        }
+        else if (value > lastNodeTime + wrap / 2)
+        {
+            value -= wrap;
+        }
+    }
+
+    return value;
+}
+
+ClockEstimator::Fit ClockEstimator::fit() const
+{
+    // least squares on centered data, slope defaults to 1 (no drift) on degenerate input
+    double xm = 0.0, ym = 0.0;
+
+    for (const auto & s : samples)
+    {
+        xm += s.first;
+        ym += s.second;
+    }
+
+    xm /= samples.size();
+    ym /= samples.size();
+
+    double sxx = 0.0, sxy = 0.0;
+
+    for (const auto & s : samples)
+    {
+        sxx += (s.first - xm) * (s.first - xm);
+        sxy += (s.first - xm) * (s.second - ym);
+    }
+
+    Fit f {xm, ym, sxx > 0.0 ? sxy / sxx : 1.0, 0.0};
+
+    for (const auto & s : samples)
+    {
+        f.error = std::max(f.error, std::abs(s.second - (ym + f.slope * (s.first - xm))));
+    }
+
+    return f;
+}
@@ -0,0 +1,77 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __CLOCK_ESTIMATOR_HPP__
+#define __CLOCK_ESTIMATOR_HPP__
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Estimates how a node clock relates to the host clock.
+ *
+ * Pairs of (host, node) timestamps are collected, e.g. the arrival time of a
+ * TPDO that maps the high resolution time stamp object (1013h) and its value.
+ * A linear fit over a sliding window of recent samples yields the clock offset
+ * and drift, the largest residual in the window bounds the estimation error.
+ * Node timestamps that wrap around (e.g. a 32-bit counter of microseconds) are
+ * unwrapped if the wrap period is known.
+ */
+class ClockEstimator final
+{
+public:
+    //! Constructor, sets the number of samples in the window and the wrap period (seconds, zero if none).
+    ClockEstimator(unsigned int window = 64, double wrap = 0.0);
+
+    //! Store a new pair of host and node timestamps (seconds).
+    void addSample(double hostTime, double nodeTime);
+
+    //! Whether there are enough samples for an estimate.
+    bool isReady() const;
+
+    //! Convert a node timestamp to the host timeline (seconds).
+    double toHostTime(double nodeTime) const;
+
+    //! Difference between host and node clocks at the last sample (seconds).
+    double getOffset() const;
+
+    //! Relative rate difference between host and node clocks.
+    double getDrift() const;
+
+    //! Largest fit residual within the window (seconds).
+    double getError() const;
+
+    //! Number of samples in the window.
+    unsigned int getSamples() const;
+
+    //! Discard all samples.
+    void reset();
+
+private:
+    struct Fit
+    {
+        double x0, y0; // reference sample
+        double slope;
+        double error;
+    };
+
+    double unwrap(double nodeTime) const;
+    Fit fit() const;
+
+    std::vector<std::pair<double, double>> samples; // (node, host), ring buffer
+    unsigned int window;
+    unsigned int next;
+    double wrap;
+    double wrapOffset;
+    double lastNodeTime;
+
+    mutable std::mutex mutex;
+};
+
+} // namespace roboticslab
+
+#endif // __CLOCK_ESTIMATOR_HPP__
@@ -0,0 +1,53 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "CobIdAllocator.hpp"
+
+#include <algorithm>
+
+#include <ColorDebug.h>
+
+using namespace roboticslab;
+
+void CobIdAllocator::request(std::uint16_t cobId, unsigned int priority)
+{
+    requests.push_back({cobId, priority});
+}
+
+bool CobIdAllocator::allocate()
+{
+    allocated.clear();
+
+    std::vector<std::uint16_t> pool;
+
+    for (const auto & request : requests)
+    {
+        pool.push_back(request.cobId);
+    }
+
+    std::sort(pool.begin(), pool.end());
+
+    if (std::adjacent_find(pool.begin(), pool.end()) != pool.end())
+    {
+        CD_ERROR("Duplicate COB-ID request.\n");
+        return false;
+    }
+
+    auto sorted = requests;
+
+    // keep default order (i.e. node id within the same function code) on equal priority
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Request & a, const Request & b)
+        { return a.priority < b.priority || (a.priority == b.priority && a.cobId < b.cobId); });
+
+    for (auto i = 0u; i < sorted.size(); i++)
+    {
+        allocated[sorted[i].cobId] = pool[i];
+    }
+
+    return true;
+}
+
+std::uint16_t CobIdAllocator::getCobId(std::uint16_t cobId) const
+{
+    auto it = allocated.find(cobId);
+    return it != allocated.end() ? it->second : cobId;
+}
@@ -0,0 +1,52 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __COB_ID_ALLOCATOR_HPP__
+#define __COB_ID_ALLOCATOR_HPP__
+
+#include <cstdint>
+
+#include <map>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Priority-driven allocation of PDO COB-IDs across the nodes of a bus.
+ *
+ * By default, each PDO is identified by a function code plus the node id, so
+ * that arbitration follows node ids: a status TPDO of a low-id node wins over
+ * the position TPDO of a high-id node. This policy collects the default COB-IDs
+ * of selected PDOs together with a priority class, and hands them back sorted:
+ * the lowest identifier goes to the most critical PDO. Since only COB-IDs that
+ * were already in use are shuffled, they cannot collide with other traffic and
+ * the lower seven bits still match a node id on the bus (as assumed by CAN
+ * acceptance filters).
+ */
+class CobIdAllocator final
+{
+public:
+    //! Register a PDO given its default COB-ID, lower @p priority values win arbitration.
+    void request(std::uint16_t cobId, unsigned int priority);
+
+    //! Distribute requested COB-IDs by priority, fails on duplicate requests.
+    bool allocate();
+
+    //! Retrieve allocated COB-ID, returns the input value if it was not requested.
+    std::uint16_t getCobId(std::uint16_t cobId) const;
+
+private:
+    struct Request
+    {
+        std::uint16_t cobId;
+        unsigned int priority;
+    };
+
+    std::vector<Request> requests;
+    std::map<std::uint16_t, std::uint16_t> allocated;
+};
+
+} // namespace roboticslab
+
+#endif // __COB_ID_ALLOCATOR_HPP__
@@ -0,0 +1,143 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "DriveStatusGroup.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "StateObserver.hpp"
+
+using namespace roboticslab;
+
+IDriveStatusProvider::~IDriveStatusProvider() = default; // key function, anchors the vtable to this library
+
+bool DriveStatusGroup::requestTransition(DriveTransition transition)
+{
+    std::vector<bool> ok(drives.size(), true);
+    std::vector<PendingDrive> pending;
+
+    for (auto i = 0u; i < drives.size(); i++)
+    {
+        DriveState nextState;
+
+        if (drives[i]->issueTransition(transition, nextState))
+        {
+            pending.push_back({i, nextState});
+        }
+        else
+        {
+            ok[i] = false;
+        }
+    }
+
+    collect(pending, ok);
+    return report(ok);
+}
+
+bool DriveStatusGroup::requestState(DriveState goalState)
+{
+    std::vector<bool> ok(drives.size(), true);
+    std::vector<std::vector<DriveTransition>> paths(drives.size());
+
+    for (auto i = 0u; i < drives.size(); i++)
+    {
+        ok[i] = DriveStatusMachine::findPath(drives[i]->getCurrentState(), goalState, paths[i]);
+    }
+
+    for (auto step = 0u; ; step++)
+    {
+        std::vector<PendingDrive> pending;
+
+        for (auto i = 0u; i < drives.size(); i++)
+        {
+            if (!ok[i] || step >= paths[i].size())
+            {
+                continue;
+            }
+
+            DriveState nextState;
+
+            if (drives[i]->issueTransition(paths[i][step], nextState))
+            {
+                pending.push_back({i, nextState});
+            }
+            else
+            {
+                ok[i] = false;
+            }
+        }
+
+        if (pending.empty())
+        {
+            break;
+        }
+
+        collect(pending, ok);
+    }
+
+    return report(ok);
+}
+
+void DriveStatusGroup::collect(const std::vector<PendingDrive> & pending, std::vector<bool> & ok) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(timeout));
+
+    std::vector<PendingDrive> waiting(pending);
+    std::vector<StateObserver *> observers;
+
+    auto isConfirmed = [this](const PendingDrive & drive) { return drives[drive.index]->getCurrentState() == drive.expected; };
+
+    // confirmations that arrived before the waiters were attached are picked up here
+    auto findConfirmed = [&waiting, &isConfirmed]
+    {
+        auto it = std::find_if(waiting.begin(), waiting.end(), isConfirmed);
+        return it != waiting.end() ? static_cast<int>(it - waiting.begin()) : -1;
+    };
+
+    while (!waiting.empty())
+    {
+        std::chrono::duration<double> remaining = deadline - std::chrono::steady_clock::now();
+        observers.clear();
+
+        for (const auto & drive : waiting)
+        {
+            observers.push_back(&drives[drive.index]->stateObserver);
+        }
+
+        int fired = awaitAny(observers, std::max(remaining.count(), 0.0), findConfirmed);
+
+        if (fired == -1)
+        {
+            for (const auto & drive : waiting)
+            {
+                ok[drive.index] = isConfirmed(drive);
+            }
+
+            return;
+        }
+
+        if (!isConfirmed(waiting[fired]))
+        {
+            // state changed, but not to the expected one
+            ok[waiting[fired].index] = false;
+        }
+
+        waiting.erase(waiting.begin() + fired);
+    }
+}
+
+bool DriveStatusGroup::report(const std::vector<bool> & ok)
+{
+    failures.clear();
+
+    for (auto i = 0u; i < ok.size(); i++)
+    {
+        if (!ok[i])
+        {
+            failures.push_back(i);
+        }
+    }
+
+    return failures.empty();
+}
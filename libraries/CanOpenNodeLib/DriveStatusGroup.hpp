@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __DRIVE_STATUS_GROUP_HPP__
+#define __DRIVE_STATUS_GROUP_HPP__
+
+#include <vector>
+
+#include "DriveStatusMachine.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Implemented by nodes that expose their CiA 402 state machine, so that
+ * bus masters can request states on several drives at once.
+ */
+class IDriveStatusProvider
+{
+public:
+    //! Destructor.
+    virtual ~IDriveStatusProvider();
+
+    //! Retrieve the CiA 402 state machine of this node.
+    virtual DriveStatusMachine * getDriveStatus() = 0;
+};
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Lockstep controller of several CiA 402 state machines.
+ *
+ * Instead of walking the transition chain of each drive one after another, every
+ * step is requested from all drives at once: controlwords are written to each RPDO
+ * in a row (thus landing in the same bus cycle if the sender is buffered), then
+ * statusword confirmations are collected in parallel against a single deadline.
+ * Drives that fail a step are left out of the following ones, the remaining ones
+ * carry on. Not meant to be used concurrently from several threads.
+ */
+class DriveStatusGroup final
+{
+public:
+    //! Constructor, sets timeout for each transition step.
+    DriveStatusGroup(double timeout)
+        : timeout(timeout)
+    { }
+
+    //! Register a drive, its position in the group is given by the insertion order.
+    void add(DriveStatusMachine * drive)
+    { drives.push_back(drive); }
+
+    //! Number of registered drives.
+    unsigned int size() const
+    { return drives.size(); }
+
+    //! Request given drive transition on all drives.
+    bool requestTransition(DriveTransition transition);
+
+    //! Request given drive state on all drives, each one following its own path.
+    bool requestState(DriveState goalState);
+
+    //! Positions of the drives that failed on the last request, if any.
+    const std::vector<unsigned int> & getFailures() const
+    { return failures; }
+
+private:
+    struct PendingDrive
+    {
+        unsigned int index;
+        DriveState expected;
+    };
+
+    void collect(const std::vector<PendingDrive> & pending, std::vector<bool> & ok) const;
+    bool report(const std::vector<bool> & ok);
+
+    std::vector<DriveStatusMachine *> drives;
+    std::vector<unsigned int> failures;
+    double timeout;
+};
+
+} // namespace roboticslab
+
+#endif // __DRIVE_STATUS_GROUP_HPP__
@@ -198,32 +198,35 @@ DriveState DriveStatusMachine::getCurrentState() const
 
 bool DriveStatusMachine::requestTransition(DriveTransition transition)
 {
-    DriveState initialState = getCurrentState();
-    auto it = nextStateOnTransition.find({initialState, transition});
-    word_t requested = updateStateBits(controlword(), static_cast<std::uint16_t>(transition));
-
-    return it != nextStateOnTransition.cend()
-            && controlword(requested)
-            && awaitState(it->second);
+    DriveState nextState;
+    return issueTransition(transition, nextState) && awaitState(nextState);
 }
 
-bool DriveStatusMachine::requestState(DriveState goalState)
+bool DriveStatusMachine::issueTransition(DriveTransition transition, DriveState & nextState)
 {
     DriveState initialState = getCurrentState();
+    auto it = nextStateOnTransition.find({initialState, transition});
 
-    if (goalState == initialState)
+    if (it == nextStateOnTransition.cend())
     {
-        return true;
+        return false;
     }
 
-    auto it = shortestPaths.find({initialState, goalState});
+    word_t requested = updateStateBits(controlword(), static_cast<std::uint16_t>(transition));
+    nextState = it->second;
+    return controlword(requested);
+}
 
-    if (it == shortestPaths.cend())
+bool DriveStatusMachine::requestState(DriveState goalState)
+{
+    std::vector<DriveTransition> path;
+
+    if (!findPath(getCurrentState(), goalState, path))
     {
         return false;
     }
 
-    for (const auto & transition : it->second)
+    for (const auto & transition : path)
     {
         if (!requestTransition(transition))
         {
@@ -248,3 +251,23 @@ DriveState DriveStatusMachine::parseStatusword(std::uint16_t statusword)
 {
     return parseDriveState(statusword);
 }
+
+bool DriveStatusMachine::findPath(DriveState initialState, DriveState goalState, std::vector<DriveTransition> & path)
+{
+    path.clear();
+
+    if (goalState == initialState)
+    {
+        return true;
+    }
+
+    auto it = shortestPaths.find({initialState, goalState});
+
+    if (it == shortestPaths.cend())
+    {
+        return false;
+    }
+
+    path = it->second;
+    return true;
+}
@@ -7,6 +7,7 @@
 
 #include <bitset>
 #include <mutex>
+#include <vector>
 
 #include "PdoProtocol.hpp"
 #include "StateObserver.hpp"
@@ -71,6 +72,10 @@ public:
     void configureRpdo(ReceivePdo * rpdo)
     { this->rpdo = rpdo; }
 
+    //! Retrieve timeout on state confirmations (seconds).
+    double getTimeout() const
+    { return stateObserver.getTimeout(); }
+
     //! Notify observers on a drive state change, if applicable.
     bool update(std::uint16_t statusword);
 
@@ -83,6 +88,26 @@ public:
     //! Send command via object 6040h and update stored controlword.
     bool controlword(const word_t & controlbits);
 
+    /**
+     * @brief Send command along with other objects mapped on the given RPDO,
+     * update stored controlword.
+     *
+     * The controlword must be mapped last, so that the drive processes the
+     * remaining objects (e.g. a new setpoint) before the command bits.
+     */
+    template<typename... Ts>
+    bool controlword(ReceivePdo * pdo, const word_t & controlbits, Ts... data)
+    {
+        if (!pdo->write(data..., static_cast<std::uint16_t>(controlbits.to_ulong())))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        _controlword = controlbits;
+        return true;
+    }
+
     //! Retrieve stored statusword.
     word_t statusword() const;
 
@@ -102,6 +127,14 @@ public:
     static DriveState parseStatusword(std::uint16_t statusword);
 
 private:
+    friend class DriveStatusGroup;
+
+    //! Send controlword for given transition without awaiting the outcome, retrieve expected state.
+    bool issueTransition(DriveTransition transition, DriveState & nextState);
+
+    //! Find the chain of transitions that leads from one state to another.
+    static bool findPath(DriveState initialState, DriveState goalState, std::vector<DriveTransition> & path);
+
     word_t _controlword;
     word_t _statusword;
     ReceivePdo * rpdo;
@@ -0,0 +1,125 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "EmcyJournal.hpp"
+
+#include <cstring>
+
+using namespace roboticslab;
+
+constexpr unsigned int EmcyJournal::MAX_CODES;
+
+namespace
+{
+    unsigned int nextPowerOfTwo(unsigned int n)
+    {
+        unsigned int p = 1;
+
+        while (p < n)
+        {
+            p <<= 1;
+        }
+
+        return p;
+    }
+}
+
+EmcyJournal::EmcyJournal(unsigned int capacity)
+    : records(nextPowerOfTwo(capacity != 0 ? capacity : 1)),
+      mask(records.size() - 1),
+      head(0),
+      tail(0),
+      dropped(0)
+{ }
+
+bool EmcyJournal::notifyMessage(const can_message & msg)
+{
+    const std::uint8_t id = msg.id & 0x7F;
+
+    if ((msg.id & 0x780) != 0x080 || id == 0 || msg.len > 8)
+    {
+        return false; // not an EMCY message (80h is SYNC)
+    }
+
+    std::uint16_t code = 0;
+
+    if (msg.len >= 2)
+    {
+        std::memcpy(&code, msg.data, 2);
+    }
+
+    count(id, code);
+
+    const unsigned int t = tail.load(std::memory_order_relaxed);
+
+    if (t - head.load(std::memory_order_acquire) > mask)
+    {
+        dropped++;
+        return false;
+    }
+
+    Record & record = records[t & mask];
+    record.id = id;
+    record.len = msg.len;
+    std::memcpy(record.data, msg.data, msg.len);
+
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+unsigned int EmcyJournal::getCount(std::uint8_t id, std::uint16_t code) const
+{
+    if (id >= nodes.size())
+    {
+        return 0;
+    }
+
+    for (const auto & counter : nodes[id].codes)
+    {
+        if (counter.used.load(std::memory_order_acquire) && counter.code == code)
+        {
+            return counter.count;
+        }
+    }
+
+    return 0;
+}
+
+bool EmcyJournal::pop(Record & record)
+{
+    const unsigned int h = head.load(std::memory_order_relaxed);
+
+    if (h == tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    record = records[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+void EmcyJournal::count(std::uint8_t id, std::uint16_t code)
+{
+    NodeCounters & node = nodes[id];
+    node.total++;
+
+    // only the producer thread inserts new codes, readers skip unused slots
+    for (auto & counter : node.codes)
+    {
+        if (!counter.used.load(std::memory_order_relaxed))
+        {
+            counter.code = code;
+            counter.count = 1;
+            counter.used.store(true, std::memory_order_release);
+            return;
+        }
+
+        if (counter.code == code)
+        {
+            counter.count++;
+            return;
+        }
+    }
+
+    // table is full, per-code count is lost but the total is kept
+}
@@ -0,0 +1,103 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __EMCY_JOURNAL_HPP__
+#define __EMCY_JOURNAL_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Bus-wide journal of raw EMCY messages.
+ *
+ * Meant to decouple the CAN reader from the (possibly expensive) handling of
+ * emergency messages. @ref notifyMessage copies incoming EMCY frames (COB-ID
+ * 80h + node id) into a fixed-size single-producer, single-consumer ring buffer
+ * and updates per-node, per-code counters in constant time and without locks.
+ * A lower priority consumer periodically calls @ref drain to decode, log or
+ * publish the stored messages. Frames are dropped (and counted) if the journal
+ * is full.
+ */
+class EmcyJournal final : public CanMessageNotifier
+{
+public:
+    //! Maximum number of distinct error codes tracked per node.
+    static constexpr unsigned int MAX_CODES = 16;
+
+    //! Constructor, capacity is rounded up to the next power of two.
+    EmcyJournal(unsigned int capacity = 256);
+
+    //! Store EMCY message and update counters, safe to call from a single producer thread.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+    //! Pop all stored messages and pass them to the callback, safe to call from a single consumer thread.
+    template<typename Fn>
+    unsigned int drain(Fn && fn)
+    {
+        Record record;
+        unsigned int count = 0;
+
+        while (pop(record))
+        {
+            fn(can_message {0x80u + record.id, record.len, record.data});
+            count++;
+        }
+
+        return count;
+    }
+
+    //! Number of EMCY messages with this error code received from this node.
+    unsigned int getCount(std::uint8_t id, std::uint16_t code) const;
+
+    //! Number of EMCY messages received from this node.
+    unsigned int getCount(std::uint8_t id) const
+    { return id < nodes.size() ? nodes[id].total.load() : 0; }
+
+    //! Number of messages that did not fit in the journal.
+    unsigned int getDropped() const
+    { return dropped; }
+
+private:
+    struct Record
+    {
+        std::uint8_t id;
+        std::uint8_t len;
+        std::uint8_t data[8];
+    };
+
+    struct CodeCounter
+    {
+        std::atomic<std::uint16_t> code {0};
+        std::atomic_uint count {0};
+        std::atomic<bool> used {false};
+    };
+
+    struct NodeCounters
+    {
+        std::array<CodeCounter, MAX_CODES> codes;
+        std::atomic_uint total {0};
+    };
+
+    bool pop(Record & record);
+    void count(std::uint8_t id, std::uint16_t code);
+
+    std::vector<Record> records;
+    unsigned int mask;
+    std::atomic_uint head; // next slot to read
+    std::atomic_uint tail; // next slot to write
+    std::atomic_uint dropped;
+
+    std::array<NodeCounters, 128> nodes;
+};
+
+} // namespace roboticslab
+
+#endif // __EMCY_JOURNAL_HPP__
@@ -0,0 +1,93 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "HeartbeatConsumer.hpp"
+
+#include <chrono>
+
+using namespace roboticslab;
+
+namespace
+{
+    inline std::int64_t nowTicks()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+}
+
+void HeartbeatConsumer::addNode(std::uint8_t id)
+{
+    if (id < entries.size() && !entries[id].monitored)
+    {
+        // the deadline runs from registration, nodes that never report are lost as well
+        entries[id].last = nowTicks();
+        entries[id].lost = false;
+        entries[id].monitored = true;
+        ids.push_back(id);
+    }
+}
+
+bool HeartbeatConsumer::isAlive(std::uint8_t id) const
+{
+    return id < entries.size() && entries[id].monitored && elapsed(entries[id], nowTicks()) <= timeout;
+}
+
+void HeartbeatConsumer::check()
+{
+    const std::int64_t now = nowTicks();
+
+    for (auto id : ids)
+    {
+        Entry & entry = entries[id];
+
+        if (entry.bootUp.exchange(false) && bootUpCallback)
+        {
+            bootUpCallback(id);
+        }
+
+        double diff = elapsed(entry, now);
+
+        if (diff <= timeout)
+        {
+            entry.lost = false;
+        }
+        else if (!entry.lost)
+        {
+            entry.lost = true;
+
+            if (lostCallback)
+            {
+                lostCallback(id, diff);
+            }
+        }
+    }
+}
+
+bool HeartbeatConsumer::notifyMessage(const can_message & msg)
+{
+    if ((msg.id & 0x780) != 0x700 || msg.len == 0)
+    {
+        return false;
+    }
+
+    Entry & entry = entries[msg.id & 0x7F];
+
+    if (!entry.monitored)
+    {
+        return false;
+    }
+
+    entry.last = nowTicks();
+
+    if (msg.data[0] == 0) // boot-up
+    {
+        entry.bootUp = true;
+    }
+
+    return true;
+}
+
+double HeartbeatConsumer::elapsed(const Entry & entry, std::int64_t now) const
+{
+    const std::chrono::steady_clock::duration ticks(now - entry.last);
+    return std::chrono::duration_cast<std::chrono::duration<double>>(ticks).count();
+}
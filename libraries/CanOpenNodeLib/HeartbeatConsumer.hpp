@@ -0,0 +1,80 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __HEARTBEAT_CONSUMER_HPP__
+#define __HEARTBEAT_CONSUMER_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Bus-wide heartbeat consumer.
+ *
+ * Tracks the arrival time of the last heartbeat (COB-ID 700h + node id) of all
+ * registered nodes in a flat array indexed by node id. The first deadline of each
+ * node runs from its registration. Deadlines are checked in
+ * a single pass by @ref check, which is meant to be invoked periodically from one
+ * thread. Handlers are called only for nodes that missed their deadline (once per
+ * loss) or announced a boot-up since the previous pass.
+ */
+class HeartbeatConsumer final : public CanMessageNotifier
+{
+public:
+    //! Constructor, sets maximum time allowed between consecutive heartbeats.
+    HeartbeatConsumer(double timeout)
+        : timeout(timeout)
+    { }
+
+    //! Start monitoring a node, not meant to be called once CAN traffic has started.
+    void addNode(std::uint8_t id);
+
+    //! Whether the last heartbeat of this node arrived in time.
+    bool isAlive(std::uint8_t id) const;
+
+    //! Check deadlines and boot-up events of all nodes, invoke handlers.
+    void check();
+
+    //! Register callback on missed heartbeat deadlines, passes node id and time since last heartbeat.
+    template<typename Fn>
+    void registerLostHandler(Fn && fn)
+    { lostCallback = fn; }
+
+    //! Register callback on boot-up events, passes node id.
+    template<typename Fn>
+    void registerBootUpHandler(Fn && fn)
+    { bootUpCallback = fn; }
+
+    //! Store heartbeat arrival time, flag boot-up events.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+private:
+    struct Entry
+    {
+        std::atomic<std::int64_t> last {0}; // steady clock ticks, registration time if never seen
+        std::atomic<bool> bootUp {false};
+        bool monitored {false};
+        bool lost {false}; // only accessed by check()
+    };
+
+    double elapsed(const Entry & entry, std::int64_t now) const;
+
+    std::array<Entry, 128> entries;
+    std::vector<std::uint8_t> ids;
+    double timeout;
+
+    std::function<void(std::uint8_t, double)> lostCallback;
+    std::function<void(std::uint8_t)> bootUpCallback;
+};
+
+} // namespace roboticslab
+
+#endif // __HEARTBEAT_CONSUMER_HPP__
@@ -0,0 +1,193 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "InterpolationBufferModel.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+namespace
+{
+    // records kept ahead of playback right after a reset, also lower bound of the safety margin
+    constexpr int MIN_MARGIN = 2;
+
+    // shrink the safety margin by one record after this many milliseconds without underflows
+    constexpr int MARGIN_DECAY_MS = 1000;
+
+    // stretch or shrink the time field of a record by at most this fraction of the period (at least 1 ms)
+    constexpr int STRETCH_DIVISOR = 16;
+}
+
+InterpolationBufferModel::InterpolationBufferModel(int _periodMs, int _bufferSize, int _targetLatencyMs, int _lowSignal)
+    : periodMs(_periodMs),
+      bufferSize(_bufferSize),
+      targetLatencyMs(_targetLatencyMs),
+      lowSignal(_lowSignal),
+      integrityCounter(0),
+      margin(MIN_MARGIN),
+      queuedMs(0),
+      smoothPeriods(0),
+      underflows(0),
+      integrityErrors(0),
+      streaming(false)
+{ }
+
+void InterpolationBufferModel::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    integrityCounter = 0;
+    margin = MIN_MARGIN;
+    queuedMs = 0;
+    smoothPeriods = 0;
+    underflows = 0;
+    integrityErrors = 0;
+    streaming = false;
+}
+
+int InterpolationBufferModel::getLeadDepth() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return computeLeadDepth();
+}
+
+int InterpolationBufferModel::getOccupancy() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return computeOccupancy();
+}
+
+int InterpolationBufferModel::getLatencyMs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedMs;
+}
+
+unsigned int InterpolationBufferModel::getUnderflows() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return underflows;
+}
+
+unsigned int InterpolationBufferModel::getIntegrityErrors() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return integrityErrors;
+}
+
+int InterpolationBufferModel::computeLeadDepth() const
+{
+    int target = periodMs > 0 ? (targetLatencyMs + periodMs / 2) / periodMs : bufferSize;
+    return std::min(std::max(target, margin), bufferSize);
+}
+
+int InterpolationBufferModel::computeOccupancy() const
+{
+    return periodMs > 0 ? (queuedMs + periodMs / 2) / periodMs : 0;
+}
+
+int InterpolationBufferModel::reserveRecords(bool stationary, int & timeMs)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    int leadDepth = computeLeadDepth();
+    timeMs = periodMs;
+
+    if (!streaming)
+    {
+        // initial prefill, playback has not started yet
+        streaming = true;
+        queuedMs = leadDepth * periodMs;
+        return leadDepth;
+    }
+
+    // the drive has played back one period since the last SYNC
+    queuedMs = std::max(queuedMs - periodMs, 0);
+
+    if (periodMs > 0 && ++smoothPeriods >= MARGIN_DECAY_MS / periodMs && margin > MIN_MARGIN)
+    {
+        margin--;
+        smoothPeriods = 0;
+    }
+
+    // shortfall with respect to the lead depth after queuing a regular record, negative if too deep
+    int error = leadDepth * periodMs - (queuedMs + periodMs);
+    int room = bufferSize - computeOccupancy();
+    int records;
+
+    if (room <= 0)
+    {
+        records = 0;
+    }
+    else if (stationary && error >= periodMs && room >= 2)
+    {
+        records = 2; // hold the last target for another period
+    }
+    else if (stationary && error <= -periodMs)
+    {
+        records = 0;
+    }
+    else
+    {
+        int stretch = std::max(periodMs / STRETCH_DIVISOR, 1);
+        timeMs += std::min(std::max(error, -std::min(stretch, periodMs - 1)), stretch);
+        records = 1;
+    }
+
+    queuedMs += records * timeMs;
+    return records;
+}
+
+std::uint8_t InterpolationBufferModel::nextIntegrityCounter()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint8_t ic = integrityCounter;
+    integrityCounter = (integrityCounter + 1) & 0x7F;
+    return ic;
+}
+
+void InterpolationBufferModel::updateStatus(std::uint16_t status, std::uint16_t previousStatus)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!streaming)
+    {
+        return;
+    }
+
+    // integrity counter of the last received record, compare with the last one sent (7-bit rollover)
+    std::uint8_t ic = status & 0x007F;
+    int inFlight = (integrityCounter - 1 - ic) & 0x7F;
+
+    if (inFlight > bufferSize)
+    {
+        inFlight = 0; // drive is ahead of us, e.g. stale counter after a reset
+    }
+
+    if ((status & 0x1000) && !(previousStatus & 0x1000))
+    {
+        // records following the faulty one are rejected by the drive, restart the sequence
+        integrityErrors++;
+        integrityCounter = (ic + 1) & 0x7F;
+        inFlight = 0;
+    }
+
+    std::uint16_t toggled = status ^ previousStatus;
+
+    // buffer flags are reported on transitions, so the drive queue was exactly at the threshold
+    if ((status & 0x8000) && (toggled & 0x8000))
+    {
+        underflows++;
+        margin = std::min(margin * 2, bufferSize);
+        smoothPeriods = 0;
+        queuedMs = inFlight * periodMs;
+    }
+    else if (toggled & 0x4000)
+    {
+        queuedMs = ((status & 0x4000 ? lowSignal : lowSignal + 1) + inFlight) * periodMs;
+    }
+    else if ((status & 0x2000) && (toggled & 0x2000))
+    {
+        queuedMs = (bufferSize + 1) * periodMs;
+    }
+
+    queuedMs = std::min(queuedMs, (bufferSize + 1) * periodMs);
+}
@@ -0,0 +1,83 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __INTERPOLATION_BUFFER_MODEL_HPP__
+#define __INTERPOLATION_BUFFER_MODEL_HPP__
+
+#include <cstdint>
+
+#include <mutex>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Host-side model of the occupancy of a drive's PT/PVT buffer.
+ *
+ * The amount of queued playback time is advanced by one period on each SYNC and
+ * corrected whenever the drive reports a buffer low/full/empty transition along
+ * with the integrity counter of the last received record. The lead depth (number
+ * of records kept ahead of playback) follows a target latency, but never falls
+ * below a safety margin that grows after each buffer underflow and slowly decays
+ * while the stream runs smoothly.
+ *
+ * One record is sent per SYNC, the lead is steered by stretching or shrinking
+ * its time field. Whole records are only added or dropped while the target is
+ * stationary, since they would otherwise distort the commanded motion.
+ */
+class InterpolationBufferModel final
+{
+public:
+    //! Constructor, sets period (ms), buffer size, target latency (ms) and buffer low threshold.
+    InterpolationBufferModel(int periodMs, int bufferSize, int targetLatencyMs, int lowSignal);
+
+    //! Set integrity counter to zero and clear occupancy model.
+    void reset();
+
+    //! Get current number of records meant to be queued ahead of playback.
+    int getLeadDepth() const;
+
+    //! Get estimated number of records queued in the drive.
+    int getOccupancy() const;
+
+    //! Get estimated delay between setpoint and playback (milliseconds).
+    int getLatencyMs() const;
+
+    //! Get number of buffer empty conditions since last reset.
+    unsigned int getUnderflows() const;
+
+    //! Get number of integrity counter errors since last reset.
+    unsigned int getIntegrityErrors() const;
+
+    //! Advance model by one period, return how many records shall be sent now and their time field (ms).
+    int reserveRecords(bool stationary, int & timeMs);
+
+    //! Retrieve the integrity counter of the next record (7 bits) and advance it.
+    std::uint8_t nextIntegrityCounter();
+
+    //! Correct model given the PT/PVT status reported by the drive (object 2072h).
+    void updateStatus(std::uint16_t status, std::uint16_t previousStatus);
+
+private:
+    int computeLeadDepth() const;
+    int computeOccupancy() const;
+
+    const int periodMs;
+    const int bufferSize;
+    const int targetLatencyMs;
+    const int lowSignal;
+
+    std::uint8_t integrityCounter;
+    int margin;
+    int queuedMs;
+    int smoothPeriods;
+    unsigned int underflows;
+    unsigned int integrityErrors;
+    bool streaming;
+
+    mutable std::mutex mutex;
+};
+
+} // namespace roboticslab
+
+#endif // __INTERPOLATION_BUFFER_MODEL_HPP__
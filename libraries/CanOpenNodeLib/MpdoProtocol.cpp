@@ -0,0 +1,142 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "MpdoProtocol.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+bool MpdoMessage::parse(const std::uint8_t * raw, unsigned int len, MpdoMessage & msg)
+{
+    if (len != 8)
+    {
+        return false;
+    }
+
+    msg.addressing = (raw[0] & 0x80) ? MpdoAddressing::DESTINATION : MpdoAddressing::SOURCE;
+    msg.id = raw[0] & 0x7F;
+    msg.index = raw[1] + (raw[2] << 8);
+    msg.subindex = raw[3];
+    msg.data = raw[4] + (raw[5] << 8) + (raw[6] << 16) + (static_cast<std::uint32_t>(raw[7]) << 24);
+
+    // SAM-MPDOs always identify their producer
+    return msg.addressing == MpdoAddressing::DESTINATION || msg.id != 0;
+}
+
+void MpdoMessage::serialize(std::uint8_t * raw) const
+{
+    raw[0] = (addressing == MpdoAddressing::DESTINATION ? 0x80 : 0x00) | (id & 0x7F);
+    raw[1] = index;
+    raw[2] = index >> 8;
+    raw[3] = subindex;
+    raw[4] = data;
+    raw[5] = data >> 8;
+    raw[6] = data >> 16;
+    raw[7] = data >> 24;
+}
+
+void MpdoProducer::addNode(std::uint8_t id)
+{
+    if (std::find(nodes.begin(), nodes.end(), id) == nodes.end())
+    {
+        nodes.push_back(id);
+    }
+}
+
+bool MpdoProducer::writeInternal(const MpdoMessage & msg)
+{
+    if (!sender)
+    {
+        return false;
+    }
+
+    std::uint8_t raw[8];
+    msg.serialize(raw);
+
+    if (!sender->prepareMessage({cobId, 8, raw}))
+    {
+        return false;
+    }
+
+    frames++;
+    setpoints += msg.id != 0 ? 1 : std::max<std::size_t>(nodes.size(), 1);
+    return true;
+}
+
+bool MpdoProducer::stageInternal(const MpdoMessage & msg)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = std::find_if(staged.begin(), staged.end(), [&msg](const MpdoMessage & other)
+        { return other.id == msg.id && other.index == msg.index && other.subindex == msg.subindex; });
+
+    if (it != staged.end())
+    {
+        *it = msg;
+    }
+    else
+    {
+        staged.push_back(msg);
+    }
+
+    return true;
+}
+
+bool MpdoProducer::flush()
+{
+    std::vector<MpdoMessage> pending;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.swap(staged);
+    }
+
+    bool ok = true;
+
+    while (!pending.empty())
+    {
+        const MpdoMessage first = pending.front();
+
+        auto isShared = [&first](const MpdoMessage & msg)
+            { return msg.index == first.index && msg.subindex == first.subindex && msg.data == first.data; };
+
+        // entries are unique per node and object, so a full count means every member agrees
+        auto members = std::count_if(pending.begin(), pending.end(), [this, &isShared](const MpdoMessage & msg)
+            { return isShared(msg) && std::find(nodes.begin(), nodes.end(), msg.id) != nodes.end(); });
+
+        if (nodes.size() > 1 && static_cast<std::size_t>(members) == nodes.size())
+        {
+            MpdoMessage broadcast = first;
+            broadcast.id = 0;
+            ok &= writeInternal(broadcast);
+
+            pending.erase(std::remove_if(pending.begin(), pending.end(), [this, &isShared](const MpdoMessage & msg)
+                { return isShared(msg) && std::find(nodes.begin(), nodes.end(), msg.id) != nodes.end(); }),
+                pending.end());
+        }
+        else
+        {
+            ok &= writeInternal(first);
+            pending.erase(pending.begin());
+        }
+    }
+
+    return ok;
+}
+
+bool MpdoConsumer::notifyMessage(const can_message & msg)
+{
+    MpdoMessage mpdo;
+
+    if (msg.id != cobId || !MpdoMessage::parse(msg.data, msg.len, mpdo) || mpdo.addressing != MpdoAddressing::SOURCE)
+    {
+        return false;
+    }
+
+    if (callback)
+    {
+        callback(mpdo.id, mpdo.index, mpdo.subindex, mpdo.data);
+    }
+
+    return true;
+}
@@ -0,0 +1,150 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __MPDO_PROTOCOL_HPP__
+#define __MPDO_PROTOCOL_HPP__
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+#include "CanSenderDelegate.hpp"
+#include "PdoProtocol.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Contents of a multiplexed PDO (CiA 301).
+ *
+ * Frames are always 8 bytes long: address byte (bit 7 set for DAM-MPDOs, node
+ * id in the lower bits), index and subindex of the target object, and up to four
+ * data bytes.
+ */
+struct MpdoMessage
+{
+    MpdoAddressing addressing; ///< Addressing scheme.
+    std::uint8_t id; ///< Destination node (DAM, 0: all nodes) or producer node (SAM).
+    std::uint16_t index; ///< Object index, in the dictionary of the consumer (DAM) or producer (SAM).
+    std::uint8_t subindex; ///< Object subindex.
+    std::uint32_t data; ///< Object value, little-endian and zero-padded.
+
+    //! Decode raw CAN message data, false if malformed.
+    static bool parse(const std::uint8_t * raw, unsigned int len, MpdoMessage & msg);
+
+    //! Encode into 8 bytes of raw CAN message data.
+    void serialize(std::uint8_t * raw) const;
+};
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Producer of destination-addressed MPDOs for a group of nodes.
+ *
+ * Setpoints may be written right away, or staged (usually by each node while
+ * preparing a SYNC cycle) and sent at once via @ref flush. In the latter case,
+ * whenever all group members have staged the same value for the same object,
+ * a single broadcast frame replaces one frame per node. Hence, every node that
+ * listens to this COB-ID must be registered as a group member. The last value
+ * staged per node and object prevails.
+ */
+class MpdoProducer final
+{
+public:
+    //! Constructor, sets COB-ID shared by all consumers.
+    MpdoProducer(std::uint16_t cobId, CanSenderDelegate * sender = nullptr)
+        : cobId(cobId), sender(sender), frames(0), setpoints(0)
+    { }
+
+    //! Retrieve COB-ID.
+    std::uint16_t getCobId() const
+    { return cobId; }
+
+    //! Configure CAN sender delegate handle.
+    void configureSender(CanSenderDelegate * sender)
+    { this->sender = sender; }
+
+    //! Register a consumer node, not meant to be called once CAN traffic has started.
+    void addNode(std::uint8_t id);
+
+    //! Send a value to a single node (0: all nodes).
+    template<typename T>
+    bool write(std::uint8_t id, std::uint16_t index, std::uint8_t subindex, T value)
+    { return writeInternal({MpdoAddressing::DESTINATION, id, index, subindex, toRaw(value)}); }
+
+    //! Queue a value for a single node until the next call to @ref flush.
+    template<typename T>
+    bool stage(std::uint8_t id, std::uint16_t index, std::uint8_t subindex, T value)
+    { return stageInternal({MpdoAddressing::DESTINATION, id, index, subindex, toRaw(value)}); }
+
+    //! Send all staged values, packing shared ones into broadcast frames.
+    bool flush();
+
+    //! Number of frames sent so far.
+    unsigned int getFrames() const
+    { return frames; }
+
+    //! Number of setpoints delivered so far, possibly exceeding @ref getFrames.
+    unsigned int getSetpoints() const
+    { return setpoints; }
+
+private:
+    template<typename T>
+    static std::uint32_t toRaw(T value)
+    {
+        static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint32_t), "Illegal type.");
+        std::uint32_t raw = 0;
+        std::memcpy(&raw, &value, sizeof(T)); // little-endian host assumed, as elsewhere
+        return raw;
+    }
+
+    bool writeInternal(const MpdoMessage & msg);
+    bool stageInternal(const MpdoMessage & msg);
+
+    std::uint16_t cobId;
+    CanSenderDelegate * sender;
+    std::vector<std::uint8_t> nodes;
+    std::vector<MpdoMessage> staged;
+    mutable std::mutex mutex;
+    std::atomic_uint frames;
+    std::atomic_uint setpoints;
+};
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Consumer of source-addressed MPDOs.
+ *
+ * Processes SAM-MPDOs sent by any producer on the configured COB-ID and passes
+ * the decoded object along with the id of the producer to a callback.
+ */
+class MpdoConsumer final : public CanMessageNotifier
+{
+public:
+    //! Callback type.
+    typedef std::function<void(std::uint8_t id, std::uint16_t index, std::uint8_t subindex, std::uint32_t data)> HandlerFn;
+
+    //! Constructor, sets COB-ID shared by all producers.
+    MpdoConsumer(std::uint16_t cobId)
+        : cobId(cobId)
+    { }
+
+    //! Register callback.
+    void registerHandler(const HandlerFn & fn)
+    { callback = fn; }
+
+    //! Process SAM-MPDOs, ignores other messages.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+private:
+    std::uint16_t cobId;
+    HandlerFn callback;
+};
+
+} // namespace roboticslab
+
+#endif // __MPDO_PROTOCOL_HPP__
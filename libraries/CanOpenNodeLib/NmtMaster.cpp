@@ -0,0 +1,202 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "NmtMaster.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "StateObserver.hpp"
+
+using namespace roboticslab;
+
+namespace
+{
+    unsigned int toMask(NmtState state)
+    {
+        switch (state)
+        {
+        case NmtState::BOOTUP:
+            return 1 << 0;
+        case NmtState::STOPPED:
+            return 1 << 1;
+        case NmtState::OPERATIONAL:
+            return 1 << 2;
+        case NmtState::PRE_OPERATIONAL:
+            return 1 << 3;
+        default:
+            return 0;
+        }
+    }
+}
+
+struct NmtMaster::Node
+{
+    Node(std::uint8_t id, double timeout, CanSenderDelegate * sender)
+        : id(id), protocol(id, sender), observer(timeout), reported(0)
+    {
+        protocol.registerHandler([this](NmtState state) { reported |= toMask(state); observer.notify(); });
+    }
+
+    std::uint8_t id;
+    NmtProtocol protocol;
+    StateObserver observer;
+    std::atomic_uint reported; // states seen since the last command, latched
+
+};
+
+NmtMaster::NmtMaster(double timeout, CanSenderDelegate * sender)
+    : broadcast(NmtProtocol::BROADCAST, sender), sender(sender), timeout(timeout)
+{ }
+
+NmtMaster::~NmtMaster()
+{
+    for (auto * node : nodes)
+    {
+        delete node;
+    }
+}
+
+void NmtMaster::configureSender(CanSenderDelegate * sender)
+{
+    this->sender = sender;
+    broadcast.configureSender(sender);
+
+    for (auto * node : nodes)
+    {
+        node->protocol.configureSender(sender);
+    }
+}
+
+void NmtMaster::addNode(std::uint8_t id)
+{
+    if (!findNode(id))
+    {
+        nodes.push_back(new Node(id, timeout, sender));
+    }
+}
+
+std::vector<std::uint8_t> NmtMaster::getNodes() const
+{
+    std::vector<std::uint8_t> ids;
+
+    for (const auto * node : nodes)
+    {
+        ids.push_back(node->id);
+    }
+
+    return ids;
+}
+
+bool NmtMaster::issueServiceCommand(NmtService command)
+{
+    // forget previous reports, confirmations must come after this command
+    for (auto * node : nodes)
+    {
+        node->reported = 0;
+    }
+
+    return broadcast.issueServiceCommand(command);
+}
+
+bool NmtMaster::issueServiceCommand(NmtService command, std::uint8_t id)
+{
+    Node * node = findNode(id);
+
+    if (!node)
+    {
+        return false;
+    }
+
+    node->reported = 0;
+    return node->protocol.issueServiceCommand(command);
+}
+
+bool NmtMaster::awaitState(NmtState state)
+{
+    return awaitNodes(nodes, state);
+}
+
+bool NmtMaster::awaitState(NmtState state, std::uint8_t id)
+{
+    Node * node = findNode(id);
+
+    if (!node)
+    {
+        failures = {id};
+        return false;
+    }
+
+    return awaitNodes({node}, state);
+}
+
+bool NmtMaster::notifyMessage(const can_message & msg)
+{
+    if ((msg.id & 0x780) != 0x700 || msg.len == 0)
+    {
+        return false;
+    }
+
+    Node * node = findNode(msg.id & 0x7F);
+    return node && node->protocol.accept(msg.data);
+}
+
+NmtMaster::Node * NmtMaster::findNode(std::uint8_t id) const
+{
+    auto it = std::find_if(nodes.begin(), nodes.end(), [id](const Node * node) { return node->id == id; });
+    return it != nodes.end() ? *it : nullptr;
+}
+
+bool NmtMaster::awaitNodes(const std::vector<Node *> & targets, NmtState state)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(timeout));
+
+    std::vector<Node *> waiting(targets);
+    std::vector<StateObserver *> observers;
+
+    auto isConfirmed = [state](const Node * node) { return (node->reported & toMask(state)) != 0; };
+
+    failures.clear();
+
+    // confirmations that arrived before the waiters were attached are picked up here
+    auto findConfirmed = [&waiting, &isConfirmed]
+    {
+        auto it = std::find_if(waiting.begin(), waiting.end(), isConfirmed);
+        return it != waiting.end() ? static_cast<int>(it - waiting.begin()) : -1;
+    };
+
+    while (!waiting.empty())
+    {
+        std::chrono::duration<double> remaining = deadline - std::chrono::steady_clock::now();
+        observers.clear();
+
+        for (auto * node : waiting)
+        {
+            observers.push_back(&node->observer);
+        }
+
+        int fired = awaitAny(observers, std::max(remaining.count(), 0.0), findConfirmed);
+
+        if (fired == -1)
+        {
+            break;
+        }
+
+        // nodes might report other states first (e.g. pre-operational heartbeats while starting)
+        if (isConfirmed(waiting[fired]))
+        {
+            waiting.erase(waiting.begin() + fired);
+        }
+    }
+
+    for (const auto * node : waiting)
+    {
+        if (!isConfirmed(node))
+        {
+            failures.push_back(node->id);
+        }
+    }
+
+    return failures.empty();
+}
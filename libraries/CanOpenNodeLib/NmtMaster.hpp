@@ -0,0 +1,85 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __NMT_MASTER_HPP__
+#define __NMT_MASTER_HPP__
+
+#include <cstdint>
+
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+#include "CanSenderDelegate.hpp"
+#include "NmtProtocol.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Bus-wide NMT master.
+ *
+ * Issues NMT service commands to all registered nodes with a single broadcast
+ * frame, then collects their boot-up or heartbeat messages in parallel against
+ * a shared deadline. Per-node commands are still available in order to recover
+ * individual nodes. Heartbeats are received through @ref notifyMessage, hence
+ * node state confirmations other than boot-up require a heartbeat producer.
+ */
+class NmtMaster final : public CanMessageNotifier
+{
+public:
+    //! Constructor, sets timeout on state confirmations.
+    NmtMaster(double timeout, CanSenderDelegate * sender = nullptr);
+
+    //! Deleted copy constructor.
+    NmtMaster(const NmtMaster &) = delete;
+
+    //! Deleted copy assignment operator.
+    NmtMaster & operator=(const NmtMaster &) = delete;
+
+    //! Destructor.
+    ~NmtMaster();
+
+    //! Configure CAN sender delegate handle.
+    void configureSender(CanSenderDelegate * sender);
+
+    //! Register a node, not meant to be called once CAN traffic has started.
+    void addNode(std::uint8_t id);
+
+    //! Retrieve ids of all registered nodes.
+    std::vector<std::uint8_t> getNodes() const;
+
+    //! Send NMT service indication to all nodes at once.
+    bool issueServiceCommand(NmtService command);
+
+    //! Send NMT service indication to a single node.
+    bool issueServiceCommand(NmtService command, std::uint8_t id);
+
+    //! Await until all nodes report given state, with timeout.
+    bool awaitState(NmtState state);
+
+    //! Await until a single node reports given state, with timeout.
+    bool awaitState(NmtState state, std::uint8_t id);
+
+    //! Ids of the nodes that failed to confirm the last awaited state, if any.
+    const std::vector<std::uint8_t> & getFailures() const
+    { return failures; }
+
+    //! Process boot-up and heartbeat messages (COB-ID 700h + node id).
+    virtual bool notifyMessage(const can_message & msg) override;
+
+private:
+    struct Node;
+
+    Node * findNode(std::uint8_t id) const;
+    bool awaitNodes(const std::vector<Node *> & targets, NmtState state);
+
+    std::vector<Node *> nodes;
+    std::vector<std::uint8_t> failures;
+    NmtProtocol broadcast;
+    CanSenderDelegate * sender;
+    double timeout;
+};
+
+} // namespace roboticslab
+
+#endif // __NMT_MASTER_HPP__
@@ -0,0 +1,221 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "NodeScanner.hpp"
+
+#include <chrono>
+
+using namespace roboticslab;
+
+namespace
+{
+    // CiA 305 command specifiers
+    constexpr std::uint8_t LSS_SWITCH_STATE_GLOBAL = 0x04;
+    constexpr std::uint8_t LSS_IDENTIFY_SLAVE = 0x4F;
+    constexpr std::uint8_t LSS_FASTSCAN = 0x51;
+
+    constexpr std::uint16_t LSS_MASTER_COB_ID = 0x7E5;
+    constexpr std::uint16_t LSS_SLAVE_COB_ID = 0x7E4;
+
+    constexpr std::uint8_t BIT_CHECKED_RESET = 0x80;
+
+    std::chrono::steady_clock::duration toDuration(double seconds)
+    {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    }
+}
+
+NodeScanner::NodeScanner(double timeout, CanSenderDelegate * sender)
+    : scanning(false), probing(false), lssResponse(false), sender(sender), timeout(timeout)
+{ }
+
+void NodeScanner::addNode(std::uint8_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    presence.emplace(id, false);
+}
+
+bool NodeScanner::scan()
+{
+    if (!sender)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto & entry : presence)
+        {
+            entry.second = false;
+        }
+    }
+
+    scanning = true;
+
+    // upload request of the device type object (1000h), mandatory on every node
+    const std::uint8_t request[8] = {0x40, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00};
+    bool ok = true;
+
+    for (const auto & entry : presence)
+    {
+        ok &= sender->prepareMessage({0x600u + entry.first, 8, request});
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    bool all = cond.wait_for(lock, toDuration(timeout), [this]
+        {
+            for (const auto & entry : presence)
+            {
+                if (!entry.second)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+    scanning = false;
+    return ok && all;
+}
+
+bool NodeScanner::isPresent(std::uint8_t id) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = presence.find(id);
+    return it != presence.end() && it->second;
+}
+
+std::vector<std::uint8_t> NodeScanner::getAbsentNodes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::uint8_t> ids;
+
+    for (const auto & entry : presence)
+    {
+        if (!entry.second)
+        {
+            ids.push_back(entry.first);
+        }
+    }
+
+    return ids;
+}
+
+std::vector<NodeScanner::LssAddress> NodeScanner::fastscan(double probeTimeout, unsigned int maxNodes)
+{
+    std::vector<LssAddress> addresses;
+
+    if (!sender)
+    {
+        return addresses;
+    }
+
+    // identified slaves switch to the configuration state and stop answering, look for the next one
+    while (addresses.size() < maxNodes && probe(0, BIT_CHECKED_RESET, 0, 0, probeTimeout))
+    {
+        LssAddress address;
+        bool found = true;
+
+        for (std::uint8_t sub = 0; sub < address.size() && found; sub++)
+        {
+            std::uint32_t idNumber = 0;
+
+            // slaves answer if their bits down to bitChecked match, hence silence means a set bit
+            for (int bit = 31; bit >= 0; bit--)
+            {
+                if (!probe(idNumber, bit, sub, sub, probeTimeout))
+                {
+                    idNumber |= 1u << bit;
+                }
+            }
+
+            address[sub] = idNumber;
+            found = probe(idNumber, 0, sub, (sub + 1) % address.size(), probeTimeout);
+        }
+
+        if (!found)
+        {
+            break;
+        }
+
+        addresses.push_back(address);
+    }
+
+    // release identified slaves
+    const std::uint8_t waiting[8] = {LSS_SWITCH_STATE_GLOBAL, 0x00};
+    sendLss(waiting);
+
+    return addresses;
+}
+
+bool NodeScanner::notifyMessage(const can_message & msg)
+{
+    if (probing && msg.id == LSS_SLAVE_COB_ID && msg.len != 0 && msg.data[0] == LSS_IDENTIFY_SLAVE)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lssResponse = true;
+        }
+
+        cond.notify_all();
+        return true;
+    }
+
+    // SDO response (580h) or boot-up/heartbeat (700h)
+    if (!scanning || ((msg.id & 0x780) != 0x580 && (msg.id & 0x780) != 0x700) || msg.len == 0)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = presence.find(msg.id & 0x7F);
+
+        if (it == presence.end())
+        {
+            return false;
+        }
+
+        it->second = true;
+    }
+
+    cond.notify_all();
+    return true;
+}
+
+bool NodeScanner::sendLss(const std::uint8_t * data)
+{
+    return sender->prepareMessage({LSS_MASTER_COB_ID, 8, data});
+}
+
+bool NodeScanner::probe(std::uint32_t idNumber, std::uint8_t bitChecked, std::uint8_t lssSub, std::uint8_t lssNext, double probeTimeout)
+{
+    const std::uint8_t request[8] = {
+        LSS_FASTSCAN,
+        static_cast<std::uint8_t>(idNumber),
+        static_cast<std::uint8_t>(idNumber >> 8),
+        static_cast<std::uint8_t>(idNumber >> 16),
+        static_cast<std::uint8_t>(idNumber >> 24),
+        bitChecked,
+        lssSub,
+        lssNext
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    lssResponse = false;
+    probing = true;
+    lock.unlock();
+
+    if (!sendLss(request))
+    {
+        probing = false;
+        return false;
+    }
+
+    lock.lock();
+    bool answered = cond.wait_for(lock, toDuration(probeTimeout), [this] { return lssResponse; });
+    probing = false;
+    return answered;
+}
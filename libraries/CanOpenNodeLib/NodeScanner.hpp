@@ -0,0 +1,87 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __NODE_SCANNER_HPP__
+#define __NODE_SCANNER_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+#include "CanSenderDelegate.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Bus-wide presence scan of CANopen nodes.
+ *
+ * Sends an SDO upload request of the device type object to all registered
+ * nodes in a single burst, then collects their responses in parallel against
+ * a shared deadline. Boot-up and heartbeat messages received meanwhile count
+ * as a confirmation of presence, too. Results are kept in a presence map until
+ * the next scan.
+ *
+ * Nodes that have not been assigned a node id yet can be identified through
+ * the LSS fastscan service (CiA 305).
+ */
+class NodeScanner final : public CanMessageNotifier
+{
+public:
+    //! LSS address: vendor id, product code, revision number, serial number.
+    using LssAddress = std::array<std::uint32_t, 4>;
+
+    //! Constructor, sets timeout of the presence scan.
+    NodeScanner(double timeout, CanSenderDelegate * sender = nullptr);
+
+    //! Deleted copy constructor.
+    NodeScanner(const NodeScanner &) = delete;
+
+    //! Deleted copy assignment operator.
+    NodeScanner & operator=(const NodeScanner &) = delete;
+
+    //! Configure CAN sender delegate handle.
+    void configureSender(CanSenderDelegate * sender)
+    { this->sender = sender; }
+
+    //! Register a node, not meant to be called once CAN traffic has started.
+    void addNode(std::uint8_t id);
+
+    //! Ping all nodes at once and await their responses, true if all of them are present.
+    bool scan();
+
+    //! Whether a node responded during the last scan.
+    bool isPresent(std::uint8_t id) const;
+
+    //! Ids of the nodes that did not respond during the last scan.
+    std::vector<std::uint8_t> getAbsentNodes() const;
+
+    //! Identify LSS slaves with no node id via fastscan, waiting up to the given time on each probe.
+    std::vector<LssAddress> fastscan(double probeTimeout, unsigned int maxNodes = 127);
+
+    //! Process SDO responses, boot-up, heartbeat and LSS messages.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+private:
+    bool sendLss(const std::uint8_t * data);
+    bool probe(std::uint32_t idNumber, std::uint8_t bitChecked, std::uint8_t lssSub, std::uint8_t lssNext, double probeTimeout);
+
+    std::map<std::uint8_t, bool> presence;
+    mutable std::mutex mutex;
+    std::condition_variable cond;
+    std::atomic_bool scanning;
+    std::atomic_bool probing;
+    bool lssResponse;
+    CanSenderDelegate * sender;
+    double timeout;
+};
+
+} // namespace roboticslab
+
+#endif // __NODE_SCANNER_HPP__
@@ -0,0 +1,47 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __OBJECT_DESCRIPTOR_HPP__
+#define __OBJECT_DESCRIPTOR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include <type_traits>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Compile-time description of a CAN dictionary object.
+ *
+ * Bundles the human-readable name, index, subindex and data type of an entry
+ * in the object dictionary of a CANopen node. Instances are meant to be declared
+ * as constexpr catalogs and passed to @ref SdoClient transfers, which check data
+ * sizes at compile time and do not need to allocate storage for the name. Use
+ * std::string as template parameter for visible string objects.
+ *
+ * @tparam T Data type of the dictionary object.
+ */
+template<typename T>
+struct ObjectDescriptor final
+{
+    using value_type = T; ///< Data type of the dictionary object.
+
+    //! Constructor.
+    constexpr ObjectDescriptor(const char * name, std::uint16_t index, std::uint8_t subindex = 0x00)
+        : name(name), index(index), subindex(subindex)
+    {}
+
+    //! Size of the dictionary object (bytes), zero for variable-length (string) objects.
+    static constexpr std::size_t size()
+    { return std::is_arithmetic<T>::value ? sizeof(T) : 0; }
+
+    const char * name;      ///< Description of the dictionary object.
+    std::uint16_t index;    ///< Index of the dictionary object.
+    std::uint8_t subindex;  ///< Subindex of the dictionary object.
+};
+
+} // namespace roboticslab
+
+#endif // __OBJECT_DESCRIPTOR_HPP__
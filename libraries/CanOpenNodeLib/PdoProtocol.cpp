@@ -2,8 +2,10 @@
 
 #include "PdoProtocol.hpp"
 
+#include <cmath>
 #include <cstring>
 
+#include <algorithm> // std::max
 #include <bitset>
 #include <vector>
 
@@ -27,6 +29,7 @@ struct PdoConfiguration::Private
     optional<std::uint16_t> inhibitTime;
     optional<std::uint16_t> eventTimer;
     optional<std::uint8_t> syncStartValue;
+    optional<MpdoAddressing> addressing;
     std::vector<std::uint32_t> mappings;
 };
 
@@ -90,33 +93,129 @@ PdoConfiguration & PdoConfiguration::setSyncStartValue(std::uint8_t value)
     return *this;
 }
 
+PdoConfiguration & PdoConfiguration::setMultiplexed(MpdoAddressing value)
+{
+    priv->addressing = value;
+    return *this;
+}
+
 void PdoConfiguration::addMappingInternal(std::uint32_t value)
 {
     priv->mappings.push_back(value);
 }
 
-bool PdoProtocol::configure(const PdoConfiguration & conf)
+unsigned int PdoConfiguration::getMappedSize() const
 {
-    std::string pdoType;
-    std::uint16_t commIdx;
-    std::uint16_t mappingIdx;
+    if (priv->addressing)
+    {
+        return 8; // address, multiplexer and up to four data bytes
+    }
+
+    unsigned int bits = 0;
+
+    for (auto mapping : priv->mappings)
+    {
+        bits += mapping & 0xFF; // object length in bits
+    }
+
+    return bits / 8;
+}
+
+bool PdoConfiguration::isSynchronousCyclic() const
+{
+    return priv->transmissionType && *priv->transmissionType >= 0x01 && *priv->transmissionType <= 0xF0;
+}
+
+double PdoConfiguration::getFramesPerSync(double syncPeriod) const
+{
+    // CiA 301 default for TPDOs of most device profiles
+    std::uint8_t type = priv->transmissionType ? *priv->transmissionType : PdoTransmissionType::EVENT_DRIVEN_DEVICE_APP_PROFILE;
+
+    switch (type)
+    {
+    case PdoTransmissionType::SYNCHRONOUS_ACYCLIC:
+        return 1.0;
+    case PdoTransmissionType::RTR_SYNCHRONOUS:
+    case PdoTransmissionType::RTR_EVENT_DRIVEN:
+        return 0.0;
+    case PdoTransmissionType::EVENT_DRIVEN_MANUFACTURER:
+    case PdoTransmissionType::EVENT_DRIVEN_DEVICE_APP_PROFILE:
+        break;
+    default:
+        return type <= 0xF0 ? 1.0 / type : 0.0; // reserved range yields nothing
+    }
+
+    if (priv->inhibitTime && *priv->inhibitTime != 0)
+    {
+        return std::ceil(syncPeriod / (*priv->inhibitTime * 1e-4)); // x100 microseconds
+    }
+
+    double frames = 1.0; // not a bound, bursts of state changes are only limited by the inhibit time
 
+    if (priv->eventTimer && *priv->eventTimer != 0)
+    {
+        frames = std::max(frames, std::ceil(syncPeriod / (*priv->eventTimer * 1e-3))); // milliseconds
+    }
+
+    return frames;
+}
+
+bool PdoProtocol::getIndices(std::string & pdoType, std::uint16_t & commIdx, std::uint16_t & mappingIdx) const
+{
     switch (getType())
     {
     case PdoType::RPDO:
         pdoType = "RPDO" + std::to_string(n);
         commIdx = 0x1400 + n - 1;
         mappingIdx = 0x1600 + n - 1;
-        break;
+        return true;
     case PdoType::TPDO:
         pdoType = "TPDO" + std::to_string(n);
         commIdx = 0x1800 + n - 1;
         mappingIdx = 0x1A00 + n - 1;
-        break;
+        return true;
     default:
         CD_ERROR("Unknown PDO type.\n");
         return false;
     }
+}
+
+bool PdoProtocol::writeMappings(const std::string & pdoType, std::uint16_t mappingIdx, const std::vector<std::uint32_t> & values, std::uint8_t entries)
+{
+    if (!sdo->download<std::uint8_t>(pdoType + " mapping parameters", 0, mappingIdx))
+    {
+        return false;
+    }
+
+    unsigned int i = 0;
+
+    for (auto mapping : values)
+    {
+        i++;
+        std::string name = pdoType + ": mapped object " + std::to_string(i);
+
+        if (!sdo->download(name, mapping, mappingIdx, i))
+        {
+            return false;
+        }
+    }
+
+    return sdo->download<std::uint8_t>(pdoType + " mapping parameters", entries, mappingIdx);
+}
+
+bool PdoProtocol::configure(const PdoConfiguration & conf)
+{
+    std::string pdoType;
+    std::uint16_t commIdx;
+    std::uint16_t mappingIdx;
+
+    if (!getIndices(pdoType, commIdx, mappingIdx))
+    {
+        return false;
+    }
+
+    bool wasMapped = mapped;
+    mapped = false; // unknown drive-side state until done
 
     std::uint32_t cobId;
 
@@ -144,6 +243,17 @@ bool PdoProtocol::configure(const PdoConfiguration & conf)
         return false;
     }
 
+    // identifier bits may only be changed once the PDO has been destroyed
+    if (customCobId != 0 && (cobId & 0x7FF) != customCobId)
+    {
+        bits = (bits.to_ulong() & ~0x7FFul) | customCobId;
+
+        if (!sdo->download<std::uint32_t>(std::string("COB-ID ") + pdoType, bits.to_ulong(), commIdx, 0x01))
+        {
+            return false;
+        }
+    }
+
     if (conf.priv->transmissionType && !sdo->download("Transmission type", static_cast<std::uint8_t>(*conf.priv->transmissionType), commIdx, 0x02))
     {
         return false;
@@ -173,31 +283,20 @@ bool PdoProtocol::configure(const PdoConfiguration & conf)
         }
     }
 
-    if (!conf.priv->mappings.empty())
+    // CiA 301: FEh selects SAM-MPDO, FFh selects DAM-MPDO
+    if (conf.priv->addressing)
     {
-        if (!sdo->download<std::uint8_t>(pdoType + " mapping parameters", 0, mappingIdx))
-        {
-            return false;
-        }
-
-        unsigned int i = 0;
-
-        for (auto mapping : conf.priv->mappings)
-        {
-            i++;
-            std::string name = pdoType + ": mapped object " + std::to_string(i);
-
-            if (!sdo->download(name, mapping, mappingIdx, i))
-            {
-                return false;
-            }
-        }
+        std::uint8_t entries = *conf.priv->addressing == MpdoAddressing::DESTINATION ? 0xFF : 0xFE;
 
-        if (!sdo->download<std::uint8_t>(pdoType + " mapping parameters", i, mappingIdx))
+        if (!writeMappings(pdoType, mappingIdx, conf.priv->mappings, entries))
         {
             return false;
         }
     }
+    else if (!conf.priv->mappings.empty() && !writeMappings(pdoType, mappingIdx, conf.priv->mappings, conf.priv->mappings.size()))
+    {
+        return false;
+    }
 
     if (!conf.priv->valid || *conf.priv->valid)
     {
@@ -209,6 +308,61 @@ bool PdoProtocol::configure(const PdoConfiguration & conf)
         }
     }
 
+    cobIdParam = bits.to_ulong();
+
+    if (conf.priv->addressing)
+    {
+        mapped = false; // not meant to be remapped
+    }
+    else if (!conf.priv->mappings.empty())
+    {
+        mappings = conf.priv->mappings;
+        mapped = true;
+    }
+    else
+    {
+        mapped = wasMapped; // mapping left untouched
+    }
+
+    return true;
+}
+
+bool PdoProtocol::remap(const PdoConfiguration & conf)
+{
+    if (!mapped || conf.priv->addressing)
+    {
+        return configure(conf);
+    }
+
+    if (conf.priv->mappings == mappings)
+    {
+        return true; // already in place
+    }
+
+    std::string pdoType;
+    std::uint16_t commIdx;
+    std::uint16_t mappingIdx;
+
+    if (!getIndices(pdoType, commIdx, mappingIdx))
+    {
+        return false;
+    }
+
+    mapped = false;
+
+    std::bitset<32> bits(cobIdParam);
+    bits.set(31);
+
+    if (!sdo->download<std::uint32_t>(std::string("COB-ID ") + pdoType, bits.to_ulong(), commIdx, 0x01)
+        || !writeMappings(pdoType, mappingIdx, conf.priv->mappings, conf.priv->mappings.size())
+        || (!std::bitset<32>(cobIdParam).test(31)
+            && !sdo->download<std::uint32_t>(std::string("COB-ID ") + pdoType, cobIdParam, commIdx, 0x01)))
+    {
+        return false;
+    }
+
+    mappings = conf.priv->mappings;
+    mapped = true;
     return true;
 }
 
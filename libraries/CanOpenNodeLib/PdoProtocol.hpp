@@ -5,10 +5,16 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
+#include <atomic>
 #include <functional>
+#include <initializer_list>
+#include <list>
+#include <string>
 #include <type_traits>
-#include <utility> // std::forward
+#include <utility> // std::forward, std::index_sequence
+#include <vector>
 
 #include "CanSenderDelegate.hpp"
 #include "SdoClient.hpp"
@@ -64,6 +70,16 @@ private:
     transmission_type type = SYNCHRONOUS_ACYCLIC;
 };
 
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Addressing scheme of a multiplexed PDO (MPDO).
+ */
+enum class MpdoAddressing
+{
+    DESTINATION, ///< DAM-MPDO, the frame carries the id of the receiving node (0: all nodes)
+    SOURCE ///< SAM-MPDO, the frame carries the id of the producer node
+};
+
 class PdoProtocol;
 
 /**
@@ -111,6 +127,9 @@ public:
     //! Set sync start value.
     PdoConfiguration & setSyncStartValue(std::uint8_t value);
 
+    //! Configure this PDO as MPDO, written to the mapping object instead of the number of entries.
+    PdoConfiguration & setMultiplexed(MpdoAddressing value);
+
     //! Configure PDO mapping, uses template parameter to deduce object size.
     template<typename T>
     PdoConfiguration & addMapping(std::uint16_t index, std::uint8_t subindex = 0x00)
@@ -121,6 +140,32 @@ public:
         return *this;
     }
 
+    //! Configure all entries of a compile-time PDO mapping, see @ref PdoMapping.
+    template<typename Mapping>
+    PdoConfiguration & addMappings()
+    {
+        Mapping::addTo(*this);
+        return *this;
+    }
+
+    //! Payload length of the configured mapping (bytes), always 8 for MPDOs.
+    unsigned int getMappedSize() const;
+
+    //! Whether the PDO is sent every N SYNC cycles, i.e. transmission type in range [1-240].
+    bool isSynchronousCyclic() const;
+
+    /**
+     * @brief Worst-case number of frames per SYNC period.
+     *
+     * Synchronous PDOs are sent at most once every N cycles, RTR-only PDOs are
+     * not accounted for. Event-driven PDOs are bounded by the inhibit time, if
+     * set. Otherwise, there is no such bound: one state change per cycle (or the
+     * event timer rate, if higher) is returned as a typical-load estimate.
+     *
+     * @param syncPeriod SYNC period (seconds).
+     */
+    double getFramesPerSync(double syncPeriod) const;
+
 private:
     void addMappingInternal(std::uint32_t value);
 
@@ -128,11 +173,100 @@ private:
     Private * priv;
 };
 
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Compile-time description of a single PDO mapping entry.
+ *
+ * @tparam T Data type of the mapped dictionary object.
+ * @tparam Index Index of the mapped dictionary object.
+ * @tparam Subindex Subindex of the mapped dictionary object.
+ */
+template<typename T, std::uint16_t Index, std::uint8_t Subindex = 0x00>
+struct PdoEntry final
+{
+    using type = T; ///< Data type of the mapped dictionary object.
+    static constexpr std::uint16_t index = Index; ///< Index of the mapped dictionary object.
+    static constexpr std::uint8_t subindex = Subindex; ///< Subindex of the mapped dictionary object.
+};
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Compile-time description of a PDO mapping.
+ *
+ * Lists @ref PdoEntry types in the order they are packed into the PDO. The same
+ * type is meant to configure the drive via @ref PdoConfiguration::addMappings
+ * and to bind a TPDO handler via @ref TransmitPdo::bindHandler, which checks at
+ * compile time that the handler parameters match this layout.
+ */
+template<typename... Entries>
+struct PdoMapping final
+{
+    static_assert(sizeof...(Entries) > 0, "Empty mapping.");
+
+    //! Cumulative size of all entries (bytes).
+    static constexpr std::size_t size()
+    {
+        std::size_t total = 0;
+
+        for (auto s : {sizeof(typename Entries::type)...})
+        {
+            total += s;
+        }
+
+        return total;
+    }
+
+    static_assert(size() <= 8, "Illegal cumulative size.");
+
+    /**
+     * @brief Whether a sequence of types can decode this mapping.
+     *
+     * Sizes must add up to the same total, and no type may straddle the boundary
+     * between two entries. A single entry may be split into several smaller types
+     * (e.g. a 32-bit register made of two 16-bit words).
+     */
+    template<typename... Ts>
+    static constexpr bool accepts()
+    {
+        const std::initializer_list<std::size_t> entries = {sizeof(typename Entries::type)...};
+        const std::initializer_list<std::size_t> params = {sizeof(Ts)...};
+
+        auto param = params.begin();
+        std::size_t entryEnd = 0, paramEnd = 0;
+
+        for (auto entry : entries)
+        {
+            entryEnd += entry;
+
+            while (paramEnd < entryEnd && param != params.end())
+            {
+                paramEnd += *param++;
+            }
+
+            if (paramEnd != entryEnd)
+            {
+                return false;
+            }
+        }
+
+        return param == params.end();
+    }
+
+    //! Register all entries in a PDO configuration.
+    static void addTo(PdoConfiguration & conf)
+    {
+        using expand = int[];
+        (void)expand{0, (conf.addMapping<typename Entries::type>(Entries::index, Entries::subindex), 0)...};
+    }
+};
+
 /**
  * @ingroup CanOpenNodeLib
  * @brief Abstract representation of PDO protocol.
  *
- * See @ref PdoConfiguration regarding how PDO configuration works.
+ * See @ref PdoConfiguration regarding how PDO configuration works. The last
+ * mapping applied to the drive is cached, so that @ref remap can switch layouts
+ * at runtime with the minimum number of SDO transfers.
  */
 class PdoProtocol
 {
@@ -147,11 +281,29 @@ public:
 
     //! Retrieve COB ID.
     std::uint16_t getCobId() const
-    { return cob + id; };
+    { return customCobId != 0 ? customCobId : cob + id; };
+
+    //! Override default COB ID, applied on @ref configure (0: restore default).
+    void setCobId(std::uint16_t cobId)
+    { customCobId = cobId; }
 
     //! Configure this PDO drive-side via SDO packages.
     virtual bool configure(const PdoConfiguration & config);
 
+    /**
+     * @brief Replace the mapping of this PDO, ignoring communication parameters.
+     *
+     * Follows the CiA 301 sequence (destroy PDO, rewrite mapping, recreate PDO)
+     * without reading back the COB-ID. Nothing is sent if the requested mapping
+     * is already in place. Falls back to @ref configure if no mapping has been
+     * applied yet, or if an MPDO is requested.
+     */
+    bool remap(const PdoConfiguration & config);
+
+    //! Forget the cached mapping, e.g. after the node has been reset.
+    void resetMappingCache()
+    { mapped = false; }
+
 protected:
     //! PDO type.
     enum class PdoType { RPDO, TPDO };
@@ -169,6 +321,15 @@ protected:
     unsigned int n;
 
     SdoClient * sdo;
+
+private:
+    bool getIndices(std::string & pdoType, std::uint16_t & commIdx, std::uint16_t & mappingIdx) const;
+    bool writeMappings(const std::string & pdoType, std::uint16_t mappingIdx, const std::vector<std::uint32_t> & values, std::uint8_t entries);
+
+    std::vector<std::uint32_t> mappings;
+    std::uint16_t customCobId {0};
+    std::uint32_t cobIdParam {0};
+    bool mapped {false};
 };
 
 /**
@@ -236,7 +397,42 @@ public:
 
     //! Invoke registered callback on raw CAN message data.
     bool accept(const std::uint8_t * data, unsigned int size)
-    { return (bool)callback && callback(data, size); }
+    { const Binding * b = binding; return b ? b->fn(b->target, data, size) : (bool)callback && callback(data, size); }
+
+    /**
+     * @brief Bind a member function as handler, checking its signature against a mapping.
+     *
+     * Unlike @ref registerHandler, no type erasure takes place: data is unpacked
+     * by a function generated at compile time for this handler and dispatched
+     * through a plain function pointer. Usage:
+     *
+     * @code
+     * tpdo->bindHandler<Mapping, decltype(&Class::method), &Class::method>(this);
+     * @endcode
+     *
+     * The handler may be rebound while receiving (e.g. after a remap), but not
+     * concurrently with other calls to this method. A bound handler takes
+     * precedence over a registered callback.
+     */
+    template<typename Mapping, typename Fn, Fn fn, typename T>
+    void bindHandler(T * obj)
+    {
+        static_assert(decoder_of<Fn, fn>::template matches<Mapping>(), "Handler does not match PDO mapping.");
+        DecoderFn decoder = &decoder_of<Fn, fn>::decode;
+
+        for (const auto & b : bindings)
+        {
+            if (b.fn == decoder && b.target == obj)
+            {
+                binding = &b;
+                return;
+            }
+        }
+
+        // published as a whole, kept alive since the reader may still hold the previous one
+        bindings.push_back({decoder, obj});
+        binding = &bindings.back();
+    }
 
     /**
      * @brief Register callback.
@@ -254,9 +450,9 @@ public:
               return size<Ts...>() == len && (ordered_call{fn, unpack<Ts>(raw, &count)...}, true); };
     }
 
-    //! Unregister callback.
+    //! Unregister callback, not safe while receiving.
     void unregisterHandler()
-    { callback = HandlerFn(); }
+    { callback = HandlerFn(); binding = nullptr; }
 
 protected:
     virtual PdoType getType() const override
@@ -264,6 +460,55 @@ protected:
 
 private:
     typedef std::function<bool(const std::uint8_t * data, unsigned int size)> HandlerFn;
+    typedef bool (*DecoderFn)(void * target, const std::uint8_t * data, unsigned int size);
+
+    struct Binding
+    {
+        DecoderFn fn;
+        void * target;
+    };
+
+    template<typename Fn, Fn fn>
+    struct decoder_of;
+
+    template<typename T, typename... Ts, void (T::*fn)(Ts...)>
+    struct decoder_of<void (T::*)(Ts...), fn>
+    {
+        static_assert(sizeof...(Ts) > 0 && size<Ts...>() <= 8, "Illegal cumulative size.");
+
+        template<typename Mapping>
+        static constexpr bool matches()
+        { return Mapping::template accepts<Ts...>(); }
+
+        static bool decode(void * target, const std::uint8_t * raw, unsigned int len)
+        { return size<Ts...>() == len && (invoke(static_cast<T *>(target), raw, std::index_sequence_for<Ts...>{}), true); }
+
+        template<std::size_t... I>
+        static void invoke(T * obj, const std::uint8_t * raw, std::index_sequence<I...>)
+        { (obj->*fn)(read<Ts>(raw + offset(I))...); }
+
+        static constexpr std::size_t offset(std::size_t i)
+        {
+            std::size_t total = 0;
+
+            for (auto s : {sizeof(Ts)...})
+            {
+                if (i-- == 0) break;
+                total += s;
+            }
+
+            return total;
+        }
+    };
+
+    template<typename T>
+    static T read(const std::uint8_t * raw)
+    {
+        static_assert(std::is_integral<T>::value, "Integral required.");
+        T data;
+        std::memcpy(&data, raw, sizeof(T));
+        return data;
+    }
 
     // https://stackoverflow.com/a/14058638
     struct ordered_call
@@ -286,6 +531,8 @@ private:
     void unpackInternal(void * data, const std::uint8_t * buff, unsigned int size);
 
     HandlerFn callback;
+    std::list<Binding> bindings;
+    std::atomic<const Binding *> binding {nullptr};
 };
 
 } // namespace roboticslab
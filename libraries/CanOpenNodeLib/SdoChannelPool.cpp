@@ -0,0 +1,129 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SdoChannelPool.hpp"
+
+using namespace roboticslab;
+
+SdoChannelPool::SdoChannelPool(SdoClient * primary)
+    : channels{{primary, true, false}}
+{ }
+
+SdoChannelPool::~SdoChannelPool()
+{
+    for (auto i = 1u; i < channels.size(); i++)
+    {
+        delete channels[i].sdo;
+    }
+}
+
+void SdoChannelPool::add(SdoClient * sdo)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    channels.push_back({sdo, false, false});
+}
+
+void SdoChannelPool::setEnabled(SdoClient * sdo, bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto i = 1u; i < channels.size(); i++)
+    {
+        if (channels[i].sdo == sdo)
+        {
+            channels[i].enabled = enabled;
+        }
+    }
+
+    cond.notify_all();
+}
+
+std::vector<SdoClient *> SdoChannelPool::getChannels() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<SdoClient *> out;
+
+    for (const auto & channel : channels)
+    {
+        out.push_back(channel.sdo);
+    }
+
+    return out;
+}
+
+unsigned int SdoChannelPool::getEnabledCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned int count = 0;
+
+    for (const auto & channel : channels)
+    {
+        count += channel.enabled;
+    }
+
+    return count;
+}
+
+SdoChannelPool::Lease SdoChannelPool::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    Channel * free = nullptr;
+
+    cond.wait(lock, [this, &free]
+        {
+            for (auto & channel : channels)
+            {
+                if (channel.enabled && !channel.busy)
+                {
+                    free = &channel;
+                    return true;
+                }
+            }
+
+            return false;
+        });
+
+    free->busy = true;
+    return {*this, free->sdo};
+}
+
+void SdoChannelPool::release(SdoClient * sdo)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto & channel : channels)
+        {
+            if (channel.sdo == sdo)
+            {
+                channel.busy = false;
+            }
+        }
+    }
+
+    cond.notify_one();
+}
+
+void SdoChannelPool::configureSender(CanSenderDelegate * sender)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto & channel : channels)
+    {
+        channel.sdo->configureSender(sender);
+    }
+}
+
+bool SdoChannelPool::notify(unsigned int cobId, const std::uint8_t * raw)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto & channel : channels)
+    {
+        if (channel.sdo->getCobIdTx() == cobId)
+        {
+            return channel.sdo->notify(raw);
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,122 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SDO_CHANNEL_POOL_HPP__
+#define __SDO_CHANNEL_POOL_HPP__
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "CanSenderDelegate.hpp"
+#include "SdoClient.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Set of SDO client channels that target the same node.
+ *
+ * CiA 301 allows a node to expose additional SDO servers (objects 1201h-127Fh)
+ * next to the default one (1200h). This pool keeps one SDO client per server
+ * channel and leases free channels to callers, so that independent transfers
+ * can overlap. The default channel is always available, additional channels
+ * must be enabled once their server parameters have been configured.
+ */
+class SdoChannelPool final
+{
+public:
+    /**
+     * @brief Exclusive handle to a leased SDO client channel.
+     *
+     * The channel is given back to the pool on destruction.
+     */
+    class Lease final
+    {
+    public:
+        //! Constructor.
+        Lease(SdoChannelPool & pool, SdoClient * sdo)
+            : pool(pool), sdo(sdo)
+        { }
+
+        //! Move constructor.
+        Lease(Lease && other)
+            : pool(other.pool), sdo(other.sdo)
+        { other.sdo = nullptr; }
+
+        //! Deleted copy constructor.
+        Lease(const Lease &) = delete;
+
+        //! Deleted copy assignment operator.
+        Lease & operator=(const Lease &) = delete;
+
+        //! Destructor, releases the channel.
+        ~Lease()
+        { if (sdo) pool.release(sdo); }
+
+        //! Access leased SDO client.
+        SdoClient * operator->() const
+        { return sdo; }
+
+        //! Retrieve leased SDO client.
+        SdoClient * get() const
+        { return sdo; }
+
+    private:
+        SdoChannelPool & pool;
+        SdoClient * sdo;
+    };
+
+    //! Constructor, registers the default channel (not owned by the pool).
+    SdoChannelPool(SdoClient * primary);
+
+    //! Deleted copy constructor.
+    SdoChannelPool(const SdoChannelPool &) = delete;
+
+    //! Deleted copy assignment operator.
+    SdoChannelPool & operator=(const SdoChannelPool &) = delete;
+
+    //! Destructor, deletes additional channels.
+    ~SdoChannelPool();
+
+    //! Register an additional channel (owned by the pool), disabled on start.
+    void add(SdoClient * sdo);
+
+    //! Enable or disable an additional channel.
+    void setEnabled(SdoClient * sdo, bool enabled);
+
+    //! Retrieve all registered channels, the default one goes first.
+    std::vector<SdoClient *> getChannels() const;
+
+    //! Number of channels that can be currently leased.
+    unsigned int getEnabledCount() const;
+
+    //! Lease a free channel, blocks until one is available.
+    Lease acquire();
+
+    //! Pass sender handle to all channels.
+    void configureSender(CanSenderDelegate * sender);
+
+    //! Forward an SDO package sent by the drive to the matching channel.
+    bool notify(unsigned int cobId, const std::uint8_t * raw);
+
+private:
+    struct Channel
+    {
+        SdoClient * sdo;
+        bool enabled;
+        bool busy;
+    };
+
+    void release(SdoClient * sdo);
+
+    std::vector<Channel> channels;
+    mutable std::mutex mutex;
+    std::condition_variable cond;
+};
+
+} // namespace roboticslab
+
+#endif // __SDO_CHANNEL_POOL_HPP__
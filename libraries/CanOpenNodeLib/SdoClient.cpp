@@ -2,9 +2,12 @@
 
 #include "SdoClient.hpp"
 
+#include <cmath>
 #include <cstring>
 
+#include <algorithm>
 #include <bitset>
+#include <chrono>
 #include <string>
 
 #include <ColorDebug.h>
@@ -15,6 +18,17 @@ using namespace roboticslab;
 
 namespace
 {
+    // RFC 6298, section 2
+    constexpr double RTT_ALPHA = 1.0 / 8;
+    constexpr double RTT_BETA = 1.0 / 4;
+    constexpr double RTT_K = 4.0;
+
+    // index and subindex of initiate requests and responses, also abort messages
+    std::uint32_t getMultiplexer(const std::uint8_t * msg)
+    {
+        return msg[1] + (msg[2] << 8) + (msg[3] << 16);
+    }
+
     std::string parseAbortCode(std::uint32_t code)
     {
         // CiA 301 v4.2.0
@@ -99,15 +113,77 @@ std::string SdoClient::msgToStr(std::uint16_t cob, const std::uint8_t * msgData)
     return CanUtils::msgToStr(id, cob, 8, msgData);
 }
 
+bool SdoClient::notify(const std::uint8_t * raw)
+{
+    switch (raw[0] >> 5) // server command specifier
+    {
+    case 2: // initiate upload response
+    case 3: // initiate download response
+    case 4: // abort transfer
+        return stateObserver.notify(raw, 8, getMultiplexer(raw));
+    default: // segments
+        return stateObserver.notify(raw, 8);
+    }
+}
+
 bool SdoClient::ping()
 {
+    std::lock_guard<std::mutex> lock(transferMutex);
     std::uint8_t requestMsg[8] = {0x40}; // index: 0x0000, subindex: 0x00
     std::uint8_t responseMsg[8];
     return send(requestMsg) && stateObserver.await(responseMsg);
 }
 
-bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+void SdoClient::configureAdaptiveTimeout(double minTimeout, double maxTimeout)
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    adaptive = true;
+    this->minTimeout = minTimeout;
+    this->maxTimeout = std::max(minTimeout, maxTimeout);
+    stateObserver.setTimeout(std::min(std::max(stateObserver.getTimeout(), this->minTimeout), this->maxTimeout));
+}
+
+SdoMetrics SdoClient::getMetrics() const
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    return {srtt, rttvar, stateObserver.getTimeout(), transfers, timeouts, retries};
+}
+
+void SdoClient::registerRoundTrip(double rtt)
 {
+    std::lock_guard<std::mutex> lock(metricsMutex);
+
+    if (transfers++ == 0)
+    {
+        srtt = rtt;
+        rttvar = rtt / 2;
+    }
+    else
+    {
+        rttvar = (1 - RTT_BETA) * rttvar + RTT_BETA * std::abs(srtt - rtt);
+        srtt = (1 - RTT_ALPHA) * srtt + RTT_ALPHA * rtt;
+    }
+
+    if (adaptive)
+    {
+        stateObserver.setTimeout(std::min(std::max(srtt + RTT_K * rttvar, minTimeout), maxTimeout));
+    }
+}
+
+void SdoClient::registerTimeout()
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    timeouts++;
+
+    if (adaptive)
+    {
+        stateObserver.setTimeout(std::min(stateObserver.getTimeout() * 2, maxTimeout)); // back off
+    }
+}
+
+bool SdoClient::uploadInternal(const char * name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+{
+    std::lock_guard<std::mutex> lock(transferMutex);
     std::uint8_t requestMsg[8] = {0};
 
     requestMsg[0] = 0x40; // client command specifier
@@ -116,7 +192,7 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
 
     std::uint8_t responseMsg[8];
 
-    if (!performTransfer(name, requestMsg, responseMsg))
+    if (!performTransfer(name, requestMsg, responseMsg, true))
     {
         return false;
     }
@@ -127,7 +203,7 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
 
     if ((bitsReceived >> 5) != 2 || expectedIndex != index || responseMsg[3] != subindex)
     {
-        CD_ERROR("SDO client request (\"%s\"). Overrun (id %d).\n", name.c_str(), id);
+        CD_ERROR("SDO client request (\"%s\"). Overrun (id %d).\n", name, id);
         return false;
     }
 
@@ -140,7 +216,7 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
 
             if (size != actualSize)
             {
-                CD_ERROR("SDO client request (\"%s\"). Size mismatch: expected %u, got %u (id %d).\n", name.c_str(), size, actualSize, id);
+                CD_ERROR("SDO client request (\"%s\"). Size mismatch: expected %u, got %u (id %d).\n", name, size, actualSize, id);
                 return false;
             }
         }
@@ -154,11 +230,11 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
 
         if (size < len)
         {
-            CD_ERROR("SDO segmented upload (\"%s\"). Insufficient memory allocated: expected %u, got %u (id %d).\n", name.c_str(), len, size, id);
+            CD_ERROR("SDO segmented upload (\"%s\"). Insufficient memory allocated: expected %u, got %u (id %d).\n", name, len, size, id);
             return false;
         }
 
-        CD_INFO("SDO segmented upload (\"%s\"). Begin (id %d).\n", name.c_str(), id);
+        CD_INFO("SDO segmented upload (\"%s\"). Begin (id %d).\n", name, id);
 
         std::bitset<8> bitsSent(0x60);
         std::uint8_t segmentedMsg[8] = {0};
@@ -177,13 +253,13 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
 
             if ((bitsReceived >> 5) != 0)
             {
-                CD_ERROR("SDO segmented upload (\"%s\"). Overrun (id %d).\n", name.c_str(), id);
+                CD_ERROR("SDO segmented upload (\"%s\"). Overrun (id %d).\n", name, id);
                 return false;
             }
 
             if (bitsReceived[4] != bitsSent[4])
             {
-                CD_ERROR("SDO segmented upload (\"%s\"). Toggle bit mismatch (id %d).\n", name.c_str(), id);
+                CD_ERROR("SDO segmented upload (\"%s\"). Toggle bit mismatch (id %d).\n", name, id);
                 return false;
             }
 
@@ -197,14 +273,15 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
         }
         while (!bitsReceived[0]); // continuation bit
 
-        CD_INFO("SDO segmented upload (\"%s\"). End (id %d).\n", name.c_str(), id);
+        CD_INFO("SDO segmented upload (\"%s\"). End (id %d).\n", name, id);
     }
 
     return true;
 }
 
-bool SdoClient::downloadInternal(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+bool SdoClient::downloadInternal(const char * name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
 {
+    std::lock_guard<std::mutex> lock(transferMutex);
     std::uint8_t indicationMsg[8] = {0};
     std::memcpy(indicationMsg + 1, &index, 2);
     indicationMsg[3] = subindex;
@@ -222,7 +299,7 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
 
         std::uint8_t confirmMsg[8];
 
-        if (!performTransfer(name, indicationMsg, confirmMsg))
+        if (!performTransfer(name, indicationMsg, confirmMsg, true))
         {
             return false;
         }
@@ -232,7 +309,7 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
 
         if ((bitsReceived >> 5) != 3 || expectedIndex != index || confirmMsg[3] != subindex)
         {
-            CD_WARNING("SDO client indication (\"%s\"). Overrun (id %d).\n", name.c_str(), id);
+            CD_WARNING("SDO client indication (\"%s\"). Overrun (id %d).\n", name, id);
             return false;
         }
     }
@@ -243,7 +320,7 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
 
         std::uint8_t confirmMsg[8];
 
-        if (!performTransfer(name, indicationMsg, confirmMsg))
+        if (!performTransfer(name, indicationMsg, confirmMsg, true))
         {
             return false;
         }
@@ -253,14 +330,14 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
 
         if ((bitsReceived >> 5) != 3 || expectedIndex != index || confirmMsg[3] != subindex)
         {
-            CD_ERROR("SDO client indication (\"%s\"). Overrun (id %d).\n", name.c_str(), id);
+            CD_ERROR("SDO client indication (\"%s\"). Overrun (id %d).\n", name, id);
             return false;
         }
 
         std::bitset<8> bitsSent(0x00);
         std::uint32_t sent = 0;
 
-        CD_INFO("SDO segmented download (\"%s\"). Begin (id %d).\n", name.c_str(), id);
+        CD_INFO("SDO segmented download (\"%s\"). Begin (id %d).\n", name, id);
 
         do
         {
@@ -291,13 +368,13 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
 
             if ((bitsReceived >> 5) != 1)
             {
-                CD_ERROR("SDO segmented download (\"%s\"). Overrun (id %d).\n", name.c_str(), id);
+                CD_ERROR("SDO segmented download (\"%s\"). Overrun (id %d).\n", name, id);
                 return false;
             }
 
             if (bitsReceived[4] != bitsSent[4])
             {
-                CD_ERROR("SDO segmented download (\"%s\"). Toggle bit mismatch (id %d).\n", name.c_str(), id);
+                CD_ERROR("SDO segmented download (\"%s\"). Toggle bit mismatch (id %d).\n", name, id);
                 return false;
             }
 
@@ -306,18 +383,23 @@ bool SdoClient::downloadInternal(const std::string & name, const void * data, st
         }
         while (!bitsSent[0]); // continuation bit
 
-        CD_INFO("SDO segmented download (\"%s\"). End (id %d.)\n", name.c_str(), id);
+        CD_INFO("SDO segmented download (\"%s\"). End (id %d.)\n", name, id);
     }
 
     return true;
 }
 
 bool SdoClient::upload(const std::string & name, std::string & s, std::uint16_t index, std::uint8_t subindex)
+{
+    return upload(ObjectDescriptor<std::string>(name.c_str(), index, subindex), s);
+}
+
+bool SdoClient::upload(const ObjectDescriptor<std::string> & obj, std::string & s)
 {
     const std::uint32_t maxLen = 100; // arbitrary high value
     char buf[maxLen] = {0};
 
-    if (!uploadInternal(name, buf, maxLen, index, subindex))
+    if (!uploadInternal(obj.name, buf, maxLen, obj.index, obj.subindex))
     {
         return false;
     }
@@ -328,33 +410,66 @@ bool SdoClient::upload(const std::string & name, std::string & s, std::uint16_t
 
 bool SdoClient::download(const std::string & name, const std::string & s, std::uint16_t index, std::uint8_t subindex)
 {
-    return downloadInternal(name, s.data(), s.size(), index, subindex);
+    return downloadInternal(name.c_str(), s.data(), s.size(), index, subindex);
 }
 
-bool SdoClient::performTransfer(const std::string & name, const std::uint8_t * req, std::uint8_t * resp)
+bool SdoClient::performTransfer(const char * name, const std::uint8_t * req, std::uint8_t * resp, bool initial)
 {
-    CD_INFO("SDO client request/indication (\"%s\"). %s\n", name.c_str(), msgToStr(cobRx, req).c_str());
+#ifndef CD_HIDE_INFO
+    // not formatted at all unless this level is logged
+    CD_INFO("SDO client request/indication (\"%s\"). %s\n", name, msgToStr(cobRx, req).c_str());
+#endif
 
-    if (!send(req))
-    {
-        CD_ERROR("SDO client request/indication (\"%s\"). Unable to send packet (id %d).\n", name.c_str(), id);
-        return false;
-    }
+    // segments are not resent since the server would notice a toggle bit mismatch
+    const unsigned int attempts = initial ? maxRetries + 1 : 1;
 
-    if (!stateObserver.await(resp))
+    for (unsigned int i = 1; ; i++)
     {
-        CD_ERROR("SDO client request/indication (\"%s\"). Inactive/timeout (id %d).\n", name.c_str(), id);
-        return false;
+        if (!send(req))
+        {
+            CD_ERROR("SDO client request/indication (\"%s\"). Unable to send packet (id %d).\n", name, id);
+            return false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // stale responses to initiate requests on other objects are ignored
+        if (stateObserver.await(resp, initial ? getMultiplexer(req) : stateObserver.ANY_KEY))
+        {
+            // Karn's algorithm: ambiguous samples from retransmitted requests are discarded
+            if (i == 1)
+            {
+                std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - start;
+                registerRoundTrip(rtt.count());
+            }
+
+            break;
+        }
+
+        registerTimeout();
+
+        if (i >= attempts)
+        {
+            CD_ERROR("SDO client request/indication (\"%s\"). Inactive/timeout (id %d).\n", name, id);
+            return false;
+        }
+
+        CD_WARNING("SDO client request/indication (\"%s\"). Timeout, retrying %u/%u (id %d).\n", name, i, maxRetries, id);
+
+        std::lock_guard<std::mutex> lock(metricsMutex);
+        retries++;
     }
 
     if (resp[0] == 0x80) // SDO abort transfer (ccs)
     {
         std::uint32_t code;
         std::memcpy(&code, resp + 4, sizeof(code));
-        CD_ERROR("SDO transfer abort (\"%s\"): %s (id %d).\n", name.c_str(), parseAbortCode(code).c_str(), id);
+        CD_ERROR("SDO transfer abort (\"%s\"): %s (id %d).\n", name, parseAbortCode(code).c_str(), id);
         return false;
     }
 
-    CD_SUCCESS("SDO server response/confirm (\"%s\"). %s\n", name.c_str(), msgToStr(cobTx, resp).c_str());
+#ifndef CD_HIDE_SUCCESS
+    CD_SUCCESS("SDO server response/confirm (\"%s\"). %s\n", name, msgToStr(cobTx, resp).c_str());
+#endif
     return true;
 }
@@ -3,18 +3,36 @@
 #ifndef __SDO_CLIENT_HPP__
 #define __SDO_CLIENT_HPP__
 
+#include <cmath>
 #include <cstdint>
 
+#include <limits>
+#include <mutex>
 #include <string>
 #include <type_traits>
 #include <utility>
 
 #include "CanSenderDelegate.hpp"
+#include "ObjectDescriptor.hpp"
 #include "StateObserver.hpp"
 
 namespace roboticslab
 {
 
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Round-trip time estimates and transfer counters of an SDO client.
+ */
+struct SdoMetrics
+{
+    double srtt;                ///< Smoothed round-trip time (seconds), zero if not sampled yet
+    double rttvar;              ///< Round-trip time variation (seconds)
+    double timeout;             ///< Timeout applied on next transfer (seconds)
+    unsigned int transfers;     ///< Number of round-trip samples, i.e. requests answered without retransmission
+    unsigned int timeouts;      ///< Number of requests that timed out
+    unsigned int retries;       ///< Number of retransmitted requests
+};
+
 /**
  * @ingroup CanOpenNodeLib
  * @brief Representation of SDO client protocol.
@@ -27,13 +45,23 @@ namespace roboticslab
  * SDO transfers block with timeout and always wait for the response or confirm
  * message from the drive, signalizing failures accordingly. Also supports SDO
  * abort protocol.
+ *
+ * Round-trip times are measured on each exchange and smoothed in the fashion of
+ * TCP retransmission timers (RFC 6298). If enabled, the transfer timeout adapts
+ * to these estimates within the given bounds and backs off on expiration.
+ * Initial requests may be optionally retransmitted on timeout.
+ *
+ * Transfers issued from different threads on the same instance are serialized.
+ * See @ref SdoChannelPool for concurrent transfers to the same node.
  */
 class SdoClient final
 {
 public:
     //! Constructor, registers CAN sender handle.
     SdoClient(std::uint8_t id, std::uint16_t cobRx, std::uint16_t cobTx, double timeout, CanSenderDelegate * sender = nullptr)
-        : id(id), cobRx(cobRx), cobTx(cobTx), sender(sender), stateObserver(timeout)
+        : id(id), cobRx(cobRx), cobTx(cobTx), sender(sender), stateObserver(timeout),
+          adaptive(false), minTimeout(timeout), maxTimeout(timeout), maxRetries(0),
+          srtt(0.0), rttvar(0.0), transfers(0), timeouts(0), retries(0)
     {}
 
     //! Retrieve COB ID of SDO packages received by the drive.
@@ -48,13 +76,30 @@ public:
     void configureSender(CanSenderDelegate * sender)
     { this->sender = sender; }
 
+    //! Retrieve CAN sender delegate handle.
+    CanSenderDelegate * getSender() const
+    { return sender; }
+
     //! Notify observers on an SDO package sent by the drive.
-    bool notify(const std::uint8_t * raw)
-    { return stateObserver.notify(raw, 8); }
+    bool notify(const std::uint8_t * raw);
 
     //! Test whether the node is available or not.
     bool ping();
 
+    /**
+     * @brief Derive transfer timeouts from measured round-trip times.
+     * @param minTimeout Lower bound of the adaptive timeout (seconds).
+     * @param maxTimeout Upper bound of the adaptive timeout (seconds).
+     */
+    void configureAdaptiveTimeout(double minTimeout, double maxTimeout);
+
+    //! Set how many times an initial request is resent on timeout.
+    void configureRetries(unsigned int retries)
+    { maxRetries = retries; }
+
+    //! Retrieve round-trip time estimates and transfer counters.
+    SdoMetrics getMetrics() const;
+
     /**
      * @brief Request an SDO package from the drive, only integral types.
      * @tparam T Integral data type.
@@ -69,7 +114,7 @@ public:
     bool upload(const std::string & name, T * data, std::uint16_t index, std::uint8_t subindex = 0x00)
     {
         static_assert(std::is_integral<T>::value, "Integral required.");
-        return uploadInternal(name, data, sizeof(T), index, subindex);
+        return uploadInternal(name.c_str(), data, sizeof(T), index, subindex);
     }
 
     /**
@@ -103,7 +148,7 @@ public:
     bool download(const std::string & name, T data, std::uint16_t index, std::uint8_t subindex = 0x00)
     {
         static_assert(std::is_integral<T>::value, "Integral required.");
-        return downloadInternal(name, &data, sizeof(T), index, subindex);
+        return downloadInternal(name.c_str(), &data, sizeof(T), index, subindex);
     }
 
     /**
@@ -147,13 +192,103 @@ public:
     bool download(const std::string & name, const char * s, std::uint16_t index, std::uint8_t subindex = 0x00)
     { return download(name, std::string(s), index, subindex); }
 
+    /**
+     * @brief Request an SDO package from the drive, only integral types.
+     * @tparam T Data type of the CAN dictionary object.
+     * @tparam U Integral data type, must match the size of @p T.
+     * @param obj Descriptor of the CAN dictionary object.
+     * @param data Pointer to an external storage, will be populated with
+     * received CAN data.
+     * @return True on success, false on timeout.
+     */
+    template<typename T, typename U>
+    bool upload(const ObjectDescriptor<T> & obj, U * data)
+    {
+        static_assert(std::is_integral<T>::value && std::is_integral<U>::value, "Integral required.");
+        static_assert(sizeof(U) == sizeof(T), "Size mismatch.");
+        return uploadInternal(obj.name, data, sizeof(T), obj.index, obj.subindex);
+    }
+
+    /**
+     * @brief Request an SDO package from the drive with callback.
+     * @tparam T Data type of the CAN dictionary object.
+     * @tparam Fn Function object type.
+     * @param obj Descriptor of the CAN dictionary object.
+     * @param fn Callback function, will be invoked with the received CAN data
+     * as input parameter.
+     * @return True on success, false on timeout.
+     */
+    template<typename T, typename Fn, typename = std::enable_if_t<!std::is_pointer<std::decay_t<Fn>>::value>>
+    bool upload(const ObjectDescriptor<T> & obj, Fn && fn)
+    {
+        T data;
+        return uploadValue(obj, data) && (std::forward<Fn>(fn)(data), true);
+    }
+
+    /**
+     * @brief Send an SDO package to the drive, only integral types.
+     * @tparam T Data type of the CAN dictionary object.
+     * @tparam U Arithmetic type of the value to be sent.
+     * @param obj Descriptor of the CAN dictionary object.
+     * @param data Value to be sent, explicitly converted to the data type of
+     * @p obj (floating-point values are rounded to the nearest integer).
+     * @return True on success, false on timeout.
+     */
+    template<typename T, typename U, typename = std::enable_if_t<std::is_integral<T>::value>>
+    bool download(const ObjectDescriptor<T> & obj, U data)
+    {
+        static_assert(std::is_arithmetic<U>::value, "Arithmetic required.");
+        T value = convert<T>(data);
+        return downloadInternal(obj.name, &value, sizeof(T), obj.index, obj.subindex);
+    }
+
+    //! Request an SDO package from the drive, only string type.
+    bool upload(const ObjectDescriptor<std::string> & obj, std::string & s);
+
+    //! Send an SDO package to the drive, only string type.
+    bool download(const ObjectDescriptor<std::string> & obj, const std::string & s)
+    { return downloadInternal(obj.name, s.data(), s.size(), obj.index, obj.subindex); }
+
 private:
     bool send(const std::uint8_t * msg);
     std::string msgToStr(std::uint16_t cob, const std::uint8_t * msgData);
 
-    bool uploadInternal(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
-    bool downloadInternal(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
-    bool performTransfer(const std::string & name, const std::uint8_t * req, std::uint8_t * resp);
+    template<typename T, typename U>
+    static std::enable_if_t<std::is_integral<U>::value, T> convert(U data)
+    { return static_cast<T>(data); }
+
+    template<typename T, typename U>
+    static std::enable_if_t<std::is_floating_point<U>::value, T> convert(U data)
+    {
+        // out-of-range conversions to integral types are undefined, saturate instead (NaN included)
+        U rounded = std::round(data);
+
+        if (!(rounded > static_cast<U>(std::numeric_limits<T>::min())))
+        {
+            return std::numeric_limits<T>::min();
+        }
+
+        if (rounded >= static_cast<U>(std::numeric_limits<T>::max()))
+        {
+            return std::numeric_limits<T>::max();
+        }
+
+        return static_cast<T>(rounded);
+    }
+
+    template<typename T>
+    bool uploadValue(const ObjectDescriptor<T> & obj, T & data)
+    { return upload(obj, &data); }
+
+    bool uploadValue(const ObjectDescriptor<std::string> & obj, std::string & s)
+    { return upload(obj, s); }
+
+    bool uploadInternal(const char * name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
+    bool downloadInternal(const char * name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
+    bool performTransfer(const char * name, const std::uint8_t * req, std::uint8_t * resp, bool initial = false);
+
+    void registerRoundTrip(double rtt);
+    void registerTimeout();
 
     std::uint8_t id;
     std::uint16_t cobRx;
@@ -161,6 +296,19 @@ private:
 
     CanSenderDelegate * sender;
     TypedStateObserver<std::uint8_t[]> stateObserver;
+    std::mutex transferMutex;
+
+    bool adaptive;
+    double minTimeout;
+    double maxTimeout;
+    unsigned int maxRetries;
+
+    double srtt;
+    double rttvar;
+    unsigned int transfers;
+    unsigned int timeouts;
+    unsigned int retries;
+    mutable std::mutex metricsMutex;
 };
 
 } // namespace roboticslab
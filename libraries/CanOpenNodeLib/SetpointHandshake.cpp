@@ -0,0 +1,56 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SetpointHandshake.hpp"
+
+#include <ColorDebug.h>
+
+using namespace roboticslab;
+
+void SetpointHandshake::registerSetpoint()
+{
+    lastSent = clock::now().time_since_epoch().count();
+    sent++;
+}
+
+bool SetpointHandshake::update(bool previous, bool current)
+{
+    if (previous || !current)
+    {
+        return false;
+    }
+
+    // set-points sent via SDO are not tracked
+    std::uint32_t _acked = acked;
+
+    while (_acked != sent && !acked.compare_exchange_weak(_acked, _acked + 1))
+    {}
+
+    return true;
+}
+
+bool SetpointHandshake::isPending()
+{
+    std::uint32_t _sent = sent;
+
+    if (acked == _sent)
+    {
+        return false;
+    }
+
+    auto elapsed = clock::now() - clock::time_point(clock::duration(lastSent.load()));
+
+    if (std::chrono::duration<double>(elapsed).count() > timeout)
+    {
+        // set-point edges coalesced or lost, rely on the statusword from now on
+        CD_WARNING("Set-point acknowledgement timed out.\n");
+        acked = _sent;
+        return false;
+    }
+
+    return true;
+}
+
+void SetpointHandshake::reset()
+{
+    acked.store(sent.load());
+}
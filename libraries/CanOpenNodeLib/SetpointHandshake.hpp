@@ -0,0 +1,56 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SETPOINT_HANDSHAKE_HPP__
+#define __SETPOINT_HANDSHAKE_HPP__
+
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Tracks the single set-point handshake of profile position mode.
+ *
+ * Set-points sent via PDO are registered before being transmitted, the drive
+ * acknowledges each of them by setting statusword bit 12. Acknowledgements
+ * are matched in order, and only on the rising edge of that bit: the drive
+ * resets it once controlword bit 4 is cleared, which does not acknowledge
+ * anything. Pending set-points are discarded after a timeout in case edges
+ * have been coalesced or lost.
+ */
+class SetpointHandshake final
+{
+public:
+    //! Constructor, sets acknowledgement timeout (seconds).
+    SetpointHandshake(double timeout)
+        : timeout(timeout), sent(0), acked(0), lastSent(0)
+    { }
+
+    //! Register a new set-point, invoke before sending it.
+    void registerSetpoint();
+
+    //! Process a statusword update, returns true on the rising edge of the acknowledgement bit.
+    bool update(bool previous, bool current);
+
+    //! Whether the last set-point is not acknowledged yet, gives up after a timeout.
+    bool isPending();
+
+    //! Discard pending set-points.
+    void reset();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    const double timeout;
+    std::atomic<std::uint32_t> sent;
+    std::atomic<std::uint32_t> acked;
+    std::atomic<clock::rep> lastSent;
+};
+
+} // namespace roboticslab
+
+#endif // __SETPOINT_HANDSHAKE_HPP__
@@ -0,0 +1,108 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "StartSkewMeter.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+void StartSkewMeter::enroll(std::uint8_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (std::find(enrolled.begin(), enrolled.end(), id) == enrolled.end())
+    {
+        enrolled.push_back(id);
+    }
+}
+
+bool StartSkewMeter::isEnrolled(std::uint8_t id) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::find(enrolled.begin(), enrolled.end(), id) != enrolled.end();
+}
+
+void StartSkewMeter::release(std::uint8_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (std::find(released.begin(), released.end(), id) == released.end())
+    {
+        released.push_back(id);
+    }
+}
+
+void StartSkewMeter::commit()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (released.size() < 2)
+    {
+        released.clear();
+        return;
+    }
+
+    if (!pending.empty())
+    {
+        incomplete++;
+    }
+
+    pending.swap(released);
+    released.clear();
+    acks.clear();
+}
+
+void StartSkewMeter::acknowledge(std::uint8_t id)
+{
+    const auto now = clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find(pending.begin(), pending.end(), id);
+
+    if (it == pending.end())
+    {
+        return;
+    }
+
+    pending.erase(it);
+    acks.push_back(now);
+
+    if (pending.empty())
+    {
+        const auto minmax = std::minmax_element(acks.begin(), acks.end());
+        lastSkew = std::chrono::duration<double>(*minmax.second - *minmax.first).count();
+        maxSkew = std::max(maxSkew, lastSkew);
+        sumSkew += lastSkew;
+        starts++;
+        acks.clear();
+    }
+}
+
+unsigned int StartSkewMeter::getStarts() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return starts;
+}
+
+unsigned int StartSkewMeter::getIncompleteStarts() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return incomplete;
+}
+
+double StartSkewMeter::getLastSkew() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastSkew;
+}
+
+double StartSkewMeter::getMaxSkew() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return maxSkew;
+}
+
+double StartSkewMeter::getMeanSkew() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return starts != 0 ? sumSkew / starts : 0.0;
+}
@@ -0,0 +1,84 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __START_SKEW_METER_HPP__
+#define __START_SKEW_METER_HPP__
+
+#include <cstdint>
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Measures start skew of motions released on the same SYNC.
+ *
+ * Nodes that take part in coordinated starts enroll once on configuration, then
+ * register themselves whenever they send a setpoint that takes effect on
+ * the next SYNC. Once the bus master commits the cycle right before sending
+ * SYNC, the registered nodes form a group. The skew of a group is the spread
+ * between the first and the last set-point acknowledgement of its members.
+ * Only groups of at least two nodes are measured. A group is deemed incomplete
+ * if a new one is committed before all acknowledgements arrive.
+ */
+class StartSkewMeter final
+{
+public:
+    //! Constructor.
+    StartSkewMeter()
+        : starts(0), incomplete(0), lastSkew(0.0), maxSkew(0.0), sumSkew(0.0)
+    { }
+
+    //! Enroll a node that releases its setpoints on SYNC.
+    void enroll(std::uint8_t id);
+
+    //! Whether this node has enrolled.
+    bool isEnrolled(std::uint8_t id) const;
+
+    //! Register a node whose setpoint will be applied on the next SYNC.
+    void release(std::uint8_t id);
+
+    //! Close the current cycle, invoked right before sending SYNC.
+    void commit();
+
+    //! Register set-point acknowledgement of a node.
+    void acknowledge(std::uint8_t id);
+
+    //! Number of measured groups.
+    unsigned int getStarts() const;
+
+    //! Number of groups with missing acknowledgements.
+    unsigned int getIncompleteStarts() const;
+
+    //! Skew of the last measured group (seconds).
+    double getLastSkew() const;
+
+    //! Maximum skew (seconds).
+    double getMaxSkew() const;
+
+    //! Average skew (seconds).
+    double getMeanSkew() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::uint8_t> enrolled;
+    std::vector<std::uint8_t> released;
+    std::vector<std::uint8_t> pending;
+    std::vector<clock::time_point> acks;
+
+    unsigned int starts;
+    unsigned int incomplete;
+    double lastSkew;
+    double maxSkew;
+    double sumSkew;
+
+    mutable std::mutex mutex;
+};
+
+} // namespace roboticslab
+
+#endif // __START_SKEW_METER_HPP__
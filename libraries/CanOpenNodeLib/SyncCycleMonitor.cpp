@@ -0,0 +1,67 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SyncCycleMonitor.hpp"
+
+#include <algorithm> // std::find
+
+using namespace roboticslab;
+
+void SyncCycleMonitor::addPdo(std::uint8_t id, std::uint16_t cobId)
+{
+    if (id >= nodes.size() || tracks.find(cobId) != tracks.end())
+    {
+        return;
+    }
+
+    tracks[cobId].id = id;
+
+    if (std::find(ids.begin(), ids.end(), id) == ids.end())
+    {
+        ids.push_back(id);
+    }
+}
+
+std::uint64_t SyncCycleMonitor::getCycle(std::uint16_t cobId) const
+{
+    auto it = tracks.find(cobId);
+    return it != tracks.end() ? it->second.last.load() : 0;
+}
+
+bool SyncCycleMonitor::notifyMessage(const can_message & msg)
+{
+    auto it = tracks.find(msg.id);
+    const std::uint64_t cycle = producer.getCycle();
+
+    if (it == tracks.end() || cycle == 0)
+    {
+        return false;
+    }
+
+    Track & track = it->second;
+    Counters & counters = nodes[track.id];
+    const std::uint64_t last = track.last;
+
+    if (last == 0 || cycle == last + 1)
+    {
+        track.gap = false;
+    }
+    else if (cycle > last + 1)
+    {
+        counters.missed += cycle - last - 1;
+        track.gap = true;
+    }
+    else if (track.gap)
+    {
+        // the previous message made up for the gap, but arrived after the next SYNC
+        counters.missed--;
+        counters.late++;
+        track.gap = false;
+    }
+    else
+    {
+        counters.duplicated++;
+    }
+
+    track.last = cycle;
+    return true;
+}
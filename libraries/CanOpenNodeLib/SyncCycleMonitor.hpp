@@ -0,0 +1,87 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SYNC_CYCLE_MONITOR_HPP__
+#define __SYNC_CYCLE_MONITOR_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "CanMessageNotifier.hpp"
+#include "SyncProducer.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Assigns SYNC cycles to incoming synchronous PDOs.
+ *
+ * Each registered PDO is expected to arrive exactly once per cycle of the bound
+ * @ref SyncProducer. Messages are tagged with the index of the current cycle on
+ * arrival, gaps are counted as missed cycles and repeated arrivals within the
+ * same cycle as duplicates. A PDO that arrives twice right after a gap is deemed
+ * late: the first message belonged to the previous cycle, but was received after
+ * the next SYNC. Counters are accumulated per node, which is registered along with
+ * each PDO since COB-IDs may have been reassigned.
+ */
+class SyncCycleMonitor final : public CanMessageNotifier
+{
+public:
+    //! Constructor, binds the producer whose cycles are tracked.
+    SyncCycleMonitor(const SyncProducer & producer)
+        : producer(producer)
+    { }
+
+    //! Track a synchronous PDO of a node, not meant to be called once CAN traffic has started.
+    void addPdo(std::uint8_t id, std::uint16_t cobId);
+
+    //! Retrieve ids of nodes with tracked PDOs.
+    const std::vector<std::uint8_t> & getNodes() const
+    { return ids; }
+
+    //! Cycle index of the last message received on this PDO, zero if none.
+    std::uint64_t getCycle(std::uint16_t cobId) const;
+
+    //! Number of cycles in which a PDO of this node did not arrive.
+    unsigned int getMissedCycles(std::uint8_t id) const
+    { return id < nodes.size() ? nodes[id].missed.load() : 0; }
+
+    //! Number of repeated PDOs of this node within the same cycle.
+    unsigned int getDuplicatedCycles(std::uint8_t id) const
+    { return id < nodes.size() ? nodes[id].duplicated.load() : 0; }
+
+    //! Number of PDOs of this node received after the next SYNC.
+    unsigned int getLateCycles(std::uint8_t id) const
+    { return id < nodes.size() ? nodes[id].late.load() : 0; }
+
+    //! Tag message with current cycle, update counters.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+private:
+    struct Track
+    {
+        std::uint8_t id {0};
+        std::atomic<std::uint64_t> last {0};
+        bool gap {false}; // only accessed by notifyMessage()
+    };
+
+    struct Counters
+    {
+        std::atomic_uint missed {0};
+        std::atomic_uint duplicated {0};
+        std::atomic_uint late {0};
+    };
+
+    const SyncProducer & producer;
+    std::unordered_map<std::uint16_t, Track> tracks;
+    std::array<Counters, 128> nodes;
+    std::vector<std::uint8_t> ids;
+};
+
+} // namespace roboticslab
+
+#endif // __SYNC_CYCLE_MONITOR_HPP__
@@ -0,0 +1,44 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SyncProducer.hpp"
+
+#include <ColorDebug.h>
+
+using namespace roboticslab;
+
+namespace
+{
+    inline std::uint8_t toCounter(std::uint64_t cycle, std::uint8_t overflow)
+    {
+        return overflow == 0 || cycle == 0 ? 0 : (cycle - 1) % overflow + 1;
+    }
+}
+
+bool SyncProducer::setCounterOverflow(std::uint8_t value)
+{
+    if (value == 1 || value > 240)
+    {
+        CD_ERROR("Illegal SYNC counter overflow value: %d.\n", value);
+        return false;
+    }
+
+    overflow = value;
+    return true;
+}
+
+bool SyncProducer::sendSync()
+{
+    if (!sender)
+    {
+        CD_ERROR("Sender delegate not configured.\n");
+        return false;
+    }
+
+    const std::uint8_t counter = toCounter(++cycle, overflow);
+    return sender->prepareMessage({0x80, overflow != 0 ? 1u : 0u, &counter});
+}
+
+std::uint8_t SyncProducer::getCounter() const
+{
+    return toCounter(cycle, overflow);
+}
@@ -0,0 +1,62 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SYNC_PRODUCER_HPP__
+#define __SYNC_PRODUCER_HPP__
+
+#include <cstdint>
+
+#include <atomic>
+
+#include "CanSenderDelegate.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief SYNC producer of a CAN bus.
+ *
+ * Sends SYNC messages (COB-ID 80h) and keeps a monotonic index of the last
+ * cycle that has been started. If a counter overflow value (CiA 301 object
+ * 1019h) has been configured, each message carries a one-byte counter that
+ * runs from 1 to this value, so that drives can align the start of their
+ * synchronous TPDOs with it.
+ */
+class SyncProducer final
+{
+public:
+    //! Constructor, registers CAN sender handle.
+    SyncProducer(CanSenderDelegate * sender = nullptr)
+        : sender(sender), overflow(0), cycle(0)
+    { }
+
+    //! Configure CAN sender delegate handle.
+    void configureSender(CanSenderDelegate * sender)
+    { this->sender = sender; }
+
+    //! Set counter overflow value, either zero (no counter) or in range [2-240].
+    bool setCounterOverflow(std::uint8_t value);
+
+    //! Retrieve counter overflow value, zero if the counter is disabled.
+    std::uint8_t getCounterOverflow() const
+    { return overflow; }
+
+    //! Start a new cycle and send a SYNC message.
+    bool sendSync();
+
+    //! Index of the last cycle, zero if no SYNC message has been sent yet.
+    std::uint64_t getCycle() const
+    { return cycle; }
+
+    //! Counter value of the last cycle, zero if disabled or not started.
+    std::uint8_t getCounter() const;
+
+private:
+    CanSenderDelegate * sender;
+    std::uint8_t overflow;
+    std::atomic<std::uint64_t> cycle;
+};
+
+} // namespace roboticslab
+
+#endif // __SYNC_PRODUCER_HPP__
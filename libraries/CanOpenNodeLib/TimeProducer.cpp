@@ -0,0 +1,41 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "TimeProducer.hpp"
+
+#include <cstring>
+
+#include <ColorDebug.h>
+
+using namespace roboticslab;
+
+namespace
+{
+    // 1984-01-01T00:00:00Z in seconds since the Unix epoch
+    constexpr std::int64_t CANOPEN_EPOCH = 441763200;
+    constexpr std::int64_t MS_PER_DAY = 86400000;
+}
+
+void TimeProducer::toTimeOfDay(const std::chrono::system_clock::time_point & time, std::uint8_t * raw)
+{
+    const auto sinceUnix = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    const std::int64_t sinceCanOpen = sinceUnix - CANOPEN_EPOCH * 1000;
+
+    const std::uint32_t ms = (sinceCanOpen % MS_PER_DAY) & 0x0FFFFFFF; // upper 4 bits are reserved
+    const std::uint16_t days = sinceCanOpen / MS_PER_DAY;
+
+    std::memcpy(raw, &ms, 4);
+    std::memcpy(raw + 4, &days, 2);
+}
+
+bool TimeProducer::sendTime(const std::chrono::system_clock::time_point & time)
+{
+    if (!sender)
+    {
+        CD_ERROR("Sender delegate not configured.\n");
+        return false;
+    }
+
+    std::uint8_t raw[6];
+    toTimeOfDay(time, raw);
+    return sender->prepareMessage({0x100, 6, raw});
+}
@@ -0,0 +1,51 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __TIME_PRODUCER_HPP__
+#define __TIME_PRODUCER_HPP__
+
+#include <cstdint>
+
+#include <chrono>
+
+#include "CanSenderDelegate.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief TIME producer of a CAN bus.
+ *
+ * Broadcasts the host wall-clock time through the CiA 301 TIME object (COB-ID
+ * 100h), encoded as TIME_OF_DAY: milliseconds after midnight (28 bits) followed
+ * by the number of days since January 1, 1984.
+ */
+class TimeProducer final
+{
+public:
+    //! Constructor, registers CAN sender handle.
+    TimeProducer(CanSenderDelegate * sender = nullptr)
+        : sender(sender)
+    { }
+
+    //! Configure CAN sender delegate handle.
+    void configureSender(CanSenderDelegate * sender)
+    { this->sender = sender; }
+
+    //! Send current time.
+    bool sendTime()
+    { return sendTime(std::chrono::system_clock::now()); }
+
+    //! Send provided time.
+    bool sendTime(const std::chrono::system_clock::time_point & time);
+
+    //! Encode time point as TIME_OF_DAY, fills 6 bytes.
+    static void toTimeOfDay(const std::chrono::system_clock::time_point & time, std::uint8_t * raw);
+
+private:
+    CanSenderDelegate * sender;
+};
+
+} // namespace roboticslab
+
+#endif // __TIME_PRODUCER_HPP__
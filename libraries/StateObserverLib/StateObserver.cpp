@@ -5,70 +5,40 @@
 #include <cstring>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
+#include <vector>
 
 using namespace roboticslab;
 
+constexpr std::uint32_t StateObserverBase::ANY_KEY;
+constexpr unsigned int StateObserverBase::DEFAULT_MAX_WAITERS;
+
 namespace
 {
-    // https://github.com/robotology/yarp/blob/cc6dfdac/src/libYARP_OS/src/Semaphore.cpp
-    class BinaryTimedSemaphore
+    // shared wake-up point of a thread that waits on several observers
+    struct WaitGroup
     {
-    public:
-        BinaryTimedSemaphore(double timeout)
-            : timeout(timeout), count(0), wakeups(0)
-        { }
-
-        bool wait()
-        {
-            std::unique_lock<std::mutex> lock(mutex);
-            count--;
-
-            if (count < 0)
-            {
-                std::chrono::duration<double> ctime(timeout);
-                cond.wait_for(lock, ctime, [this] { return wakeups > 0; });
-
-                if (wakeups <= 0)
-                {
-                    count++;
-                    return false;
-                }
-
-                wakeups--;
-            }
-
-            return true;
-        }
-
-        void post()
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            count++;
-
-            if (count <= 0)
-            {
-                wakeups++;
-                cond.notify_one();
-            }
-        }
-
-    private:
-        double timeout;
-        int count;
-        int wakeups;
-
         std::mutex mutex;
         std::condition_variable cond;
+        unsigned int fired = 0;
+        int first = -1;
     };
+
+    std::chrono::steady_clock::time_point makeDeadline(double timeout)
+    {
+        const auto duration = std::chrono::duration<double>(timeout);
+        return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+    }
 }
 
 class StateObserverBase::Private
 {
 public:
-    Private(StateObserverBase & _owner)
-        : owner(_owner), semaphore(nullptr), remoteStorage(nullptr), active(true)
+    Private(StateObserverBase & _owner, unsigned int maxWaiters)
+        : owner(_owner), slots(maxWaiters != 0 ? maxWaiters : 1), waiters(0), active(true)
     { }
 
     ~Private()
@@ -76,49 +46,105 @@ public:
         interrupt();
     }
 
-    bool await(void * raw)
+    bool await(void * raw, std::uint32_t key)
     {
-        std::lock_guard<std::mutex> awaitLock(awaitMutex);
-
         if (!active)
         {
             return false;
         }
 
+        const auto deadline = makeDeadline(owner.getTimeout());
+
+        std::unique_lock<std::mutex> lock(mutex);
+        WaitSlot * slot = nullptr;
+
+        // all slots taken, wait until another waiter leaves
+        if (!slotReleased.wait_until(lock, deadline, [this, &slot] { return !active || (slot = findFreeSlot()); }) || !active)
         {
-            std::lock_guard<std::mutex> registryLock(registryMutex);
-            semaphore = new BinaryTimedSemaphore(owner.getTimeout());
-            remoteStorage = raw;
+            return false;
         }
 
-        bool timedOut = !semaphore->wait();
+        occupy(slot, raw, key, nullptr, 0);
+
+        slot->cond.wait_until(lock, deadline, [this, slot] { return slot->signaled || !active; });
 
+        bool signaled = release(slot);
+        lock.unlock();
+        slotReleased.notify_one();
+        return signaled;
+    }
+
+    // register a non-blocking waiter that reports to a group, fails if all slots are taken
+    void * attach(WaitGroup * group, int index)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        WaitSlot * slot = active ? findFreeSlot() : nullptr;
+
+        if (slot)
         {
-            std::lock_guard<std::mutex> registryLock(registryMutex);
-            delete semaphore;
-            semaphore = nullptr;
+            occupy(slot, nullptr, ANY_KEY, group, index);
         }
 
-        return !timedOut;
+        return slot;
     }
 
-    bool notify(const void * raw, std::size_t len)
+    bool detach(void * handle)
+    {
+        bool signaled;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            signaled = release(static_cast<WaitSlot *>(handle));
+        }
+
+        slotReleased.notify_one();
+        return signaled;
+    }
+
+    bool notify(const void * raw, std::size_t len, std::uint32_t key)
     {
         if (!active)
         {
             return false;
         }
 
-        std::lock_guard<std::mutex> lock(registryMutex);
+        if (waiters == 0)
+        {
+            return true; // fast path, nobody to wake up
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
 
-        if (semaphore != nullptr)
+        for (auto & slot : slots)
         {
-            if (raw != nullptr)
+            if (slot.inUse && !slot.signaled && (key == ANY_KEY || slot.key == ANY_KEY || slot.key == key))
             {
-                owner.setRemoteStorage(raw, len);
-            }
+                if (raw != nullptr && slot.storage != nullptr)
+                {
+                    owner.setRemoteStorage(slot.storage, raw, len);
+                }
+
+                slot.signaled = true;
+
+                if (slot.group)
+                {
+                    {
+                        std::lock_guard<std::mutex> groupLock(slot.group->mutex);
+                        slot.group->fired++;
 
-            semaphore->post();
+                        if (slot.group->first == -1)
+                        {
+                            slot.group->first = slot.groupIndex;
+                        }
+                    }
+
+                    slot.group->cond.notify_one();
+                }
+                else
+                {
+                    slot.cond.notify_one();
+                }
+            }
         }
 
         return true;
@@ -127,37 +153,73 @@ public:
     void interrupt()
     {
         active = false;
-        std::lock_guard<std::mutex> lock(registryMutex);
+        std::lock_guard<std::mutex> lock(mutex);
 
-        if (semaphore != nullptr)
+        for (auto & slot : slots)
         {
-            semaphore->post();
+            slot.cond.notify_one();
         }
+
+        slotReleased.notify_all();
     }
 
-    void * getRemoteStorage()
+private:
+    struct WaitSlot
     {
-        return remoteStorage;
+        std::condition_variable cond;
+        void * storage = nullptr;
+        std::uint32_t key = ANY_KEY;
+        WaitGroup * group = nullptr;
+        int groupIndex = 0;
+        bool inUse = false;
+        bool signaled = false;
+    };
+
+    void occupy(WaitSlot * slot, void * raw, std::uint32_t key, WaitGroup * group, int groupIndex)
+    {
+        slot->storage = raw;
+        slot->key = key;
+        slot->group = group;
+        slot->groupIndex = groupIndex;
+        slot->signaled = false;
+        slot->inUse = true;
+        waiters++;
     }
 
-    const void * getRemoteStorage() const
+    bool release(WaitSlot * slot)
     {
-        return remoteStorage;
+        slot->inUse = false;
+        slot->storage = nullptr;
+        slot->group = nullptr;
+        waiters--;
+        return slot->signaled;
     }
 
-private:
-    StateObserverBase & owner;
+    WaitSlot * findFreeSlot()
+    {
+        for (auto & slot : slots)
+        {
+            if (!slot.inUse)
+            {
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
 
-    BinaryTimedSemaphore * semaphore;
-    void * remoteStorage;
+    StateObserverBase & owner;
 
+    std::vector<WaitSlot> slots; // preallocated, never resized
+    std::atomic_uint waiters;
     std::atomic_bool active;
-    std::mutex registryMutex;
-    std::mutex awaitMutex;
+
+    std::mutex mutex;
+    std::condition_variable slotReleased;
 };
 
-StateObserverBase::StateObserverBase(double _timeout)
-    : timeout(_timeout), impl(new Private(*this))
+StateObserverBase::StateObserverBase(double _timeout, unsigned int maxWaiters)
+    : timeout(_timeout), impl(new Private(*this, maxWaiters))
 { }
 
 StateObserverBase::~StateObserverBase()
@@ -165,27 +227,80 @@ StateObserverBase::~StateObserverBase()
     delete impl;
 }
 
-void * StateObserverBase::getRemoteStorage()
+void StateObserverBase::setRemoteStorage(void * storage, const void * raw, std::size_t len)
+{
+    std::memcpy(storage, raw, len);
+}
+
+bool StateObserverBase::await(void * raw, std::uint32_t key)
 {
-    return impl->getRemoteStorage();
+    return impl->await(raw, key);
 }
 
-const void * StateObserverBase::getRemoteStorage() const
+bool StateObserverBase::notify(const void * raw, std::size_t len, std::uint32_t key)
 {
-    return impl->getRemoteStorage();
+    return impl->notify(raw, len, key);
 }
 
-void StateObserverBase::setRemoteStorage(const void * raw, std::size_t len)
+namespace
 {
-    std::memcpy(impl->getRemoteStorage(), raw, len);
+    template<typename Impl, typename Pred>
+    bool awaitGroup(const std::vector<Impl *> & impls, double timeout, WaitGroup & group, Pred && pred,
+            const std::function<int()> & ready = nullptr)
+    {
+        std::vector<void *> handles(impls.size(), nullptr);
+        bool ok = true;
+
+        for (auto i = 0u; i < impls.size() && ok; i++)
+        {
+            ok = (handles[i] = impls[i]->attach(&group, i)) != nullptr;
+        }
+
+        // checked past attachment, a notification in between can't get lost
+        int index = ok && ready ? ready() : -1;
+
+        if (index != -1)
+        {
+            std::lock_guard<std::mutex> lock(group.mutex);
+            group.first = index;
+        }
+        else if (ok)
+        {
+            std::unique_lock<std::mutex> lock(group.mutex);
+            ok = group.cond.wait_until(lock, makeDeadline(timeout), [&group, &pred] { return pred(group); });
+        }
+
+        for (auto i = 0u; i < impls.size(); i++)
+        {
+            if (handles[i])
+            {
+                impls[i]->detach(handles[i]);
+            }
+        }
+
+        return ok;
+    }
 }
 
-bool StateObserverBase::await(void * raw)
+int roboticslab::awaitAny(const std::vector<StateObserver *> & observers, double timeout)
 {
-    return impl->await(raw);
+    return awaitAny(observers, timeout, nullptr);
 }
 
-bool StateObserverBase::notify(const void * raw, std::size_t len)
+int roboticslab::awaitAny(const std::vector<StateObserver *> & observers, double timeout, const std::function<int()> & ready)
 {
-    return impl->notify(raw, len);
+    std::vector<StateObserverBase::Private *> impls;
+
+    for (auto * observer : observers)
+    {
+        impls.push_back(static_cast<StateObserverBase *>(observer)->impl);
+    }
+
+    if (impls.empty())
+    {
+        return -1;
+    }
+
+    WaitGroup group;
+    return awaitGroup(impls, timeout, group, [](const WaitGroup & g) { return g.fired != 0; }, ready) ? group.first : -1;
 }
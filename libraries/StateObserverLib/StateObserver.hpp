@@ -6,11 +6,36 @@
 #include <cstdint>
 #include <cstdlib>
 
+#include <atomic>
+#include <functional>
 #include <type_traits>
+#include <vector>
 
 namespace roboticslab
 {
 
+class StateObserver;
+
+/**
+ * @ingroup StateObserverLib
+ * @brief Wait until any observer is notified or a shared timeout elapses.
+ * @param observers Set of observers to wait on.
+ * @param timeout Deadline for the whole set (seconds).
+ * @return Position of the first notified observer, -1 on timeout.
+ */
+int awaitAny(const std::vector<StateObserver *> & observers, double timeout);
+
+/**
+ * @ingroup StateObserverLib
+ * @brief Wait until any observer is notified or its awaited condition already holds.
+ * @param observers Set of observers to wait on.
+ * @param timeout Deadline for the whole set (seconds).
+ * @param ready Invoked once all waiters are attached, returns the position of an
+ * observer whose condition holds or -1; later notifications are not missed.
+ * @return Position of the first ready or notified observer, -1 on timeout.
+ */
+int awaitAny(const std::vector<StateObserver *> & observers, double timeout, const std::function<int()> & ready);
+
 /**
  * @ingroup yarp_devices_libraries
  * @defgroup StateObserverLib
@@ -24,12 +49,25 @@ namespace roboticslab
  * This monitor class provides a synchronized timeout mechanism for clients to
  * wait for a specific event to happen. A call to @ref await blocks the caller
  * until @ref notify is invoked by another thread or the timeout has elapsed.
+ *
+ * Several threads may wait at the same time, up to the number of wait slots
+ * reserved on construction; no memory is allocated on each wait. Waiters may
+ * optionally specify a key, in which case they are only woken up by notifiers
+ * that pass the same key or no key at all. Notifying an observer nobody waits
+ * on does not take any lock. See @ref awaitAny for waits on
+ * sets of observers.
  */
 class StateObserverBase
 {
 public:
-    //! Constructor, configure with timeout in seconds.
-    StateObserverBase(double timeout);
+    //! Wildcard key, matches any waiter or notifier.
+    static constexpr std::uint32_t ANY_KEY = 0xFFFFFFFF;
+
+    //! Default number of wait slots.
+    static constexpr unsigned int DEFAULT_MAX_WAITERS = 4;
+
+    //! Constructor, configure with timeout in seconds and number of wait slots.
+    StateObserverBase(double timeout, unsigned int maxWaiters = DEFAULT_MAX_WAITERS);
 
     //! Virtual destructor.
     virtual ~StateObserverBase() = 0;
@@ -44,24 +82,24 @@ public:
     double getTimeout() const
     { return timeout; }
 
+    //! Configure timeout (in seconds), applies to subsequent calls to @ref await.
+    void setTimeout(double timeout)
+    { this->timeout = timeout; }
+
     //! Causes the current thread to wait until @ref notify is invoked or the timeout elapses.
-    bool await(void * raw = nullptr);
+    bool await(void * raw = nullptr, std::uint32_t key = ANY_KEY);
 
-    //! Wake up a thread that waits on this object's monitor.
-    bool notify(const void * raw = nullptr, std::size_t len = 0);
+    //! Wake up all threads that wait on this object's monitor with a matching key.
+    bool notify(const void * raw = nullptr, std::size_t len = 0, std::uint32_t key = ANY_KEY);
 
 protected:
-    //! Retrieve modifiable handle to notified data storage.
-    void * getRemoteStorage();
-
-    //! Retrieve non-modifiable handle to notified data storage.
-    const void * getRemoteStorage() const;
-
-    //! Set data storage to notify observers with.
-    virtual void setRemoteStorage(const void * ptr, std::size_t len);
+    //! Copy notified data into the storage provided by a waiter.
+    virtual void setRemoteStorage(void * storage, const void * raw, std::size_t len);
 
 private:
-    double timeout;
+    friend int awaitAny(const std::vector<StateObserver *> &, double, const std::function<int()> &);
+
+    std::atomic<double> timeout;
 
     class Private;
     Private * impl;
@@ -75,14 +113,20 @@ class StateObserver final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
+    using StateObserverBase::setTimeout;
+    using StateObserverBase::ANY_KEY;
 
     //! Wait with timeout until another thread invokes @ref notify.
-    bool await()
-    { return StateObserverBase::await(); }
+    bool await(std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::await(nullptr, key); }
 
-    //! Wakes up a waiting thread.
-    bool notify()
-    { return StateObserverBase::notify(); }
+    //! Wakes up waiting threads.
+    bool notify(std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::notify(nullptr, 0, key); }
+
+private:
+    friend int awaitAny(const std::vector<StateObserver *> &, double, const std::function<int()> &);
 };
 
 /**
@@ -95,18 +139,21 @@ class TypedStateObserver final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
+    using StateObserverBase::setTimeout;
+    using StateObserverBase::ANY_KEY;
 
     //! Wait with timeout until another thread invokes @ref notify.
-    bool await(T & remote)
-    { return StateObserverBase::await(&remote); }
+    bool await(T & remote, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::await(&remote, key); }
 
-    //! Wakes up a waiting thread.
-    bool notify(const T & remote)
-    { return StateObserverBase::notify(&remote); }
+    //! Wakes up waiting threads.
+    bool notify(const T & remote, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::notify(&remote, 0, key); }
 
 protected:
-    virtual void setRemoteStorage(const void * remote, std::size_t len) override
-    { *static_cast<T *>(getRemoteStorage()) = *static_cast<const T *>(remote); }
+    virtual void setRemoteStorage(void * storage, const void * remote, std::size_t) override
+    { *static_cast<T *>(storage) = *static_cast<const T *>(remote); }
 };
 
 /**
@@ -119,18 +166,21 @@ class TypedStateObserver<T, typename std::enable_if_t<std::is_arithmetic<T>::val
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
+    using StateObserverBase::setTimeout;
+    using StateObserverBase::ANY_KEY;
 
     //! Wait with timeout until another thread invokes @ref notify.
-    bool await(T * raw)
-    { return StateObserverBase::await(raw); }
+    bool await(T * raw, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::await(raw, key); }
 
-    //! Wakes up a waiting thread.
-    bool notify(T raw)
-    { return StateObserverBase::notify(&raw, sizeof(T)); }
+    //! Wakes up waiting threads.
+    bool notify(T raw, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::notify(&raw, sizeof(T), key); }
 
-    //! Wakes up a waiting thread with byte array.
-    bool notify(const std::uint8_t * raw, std::size_t len)
-    { return len == sizeof(T) && StateObserverBase::notify(raw, len); }
+    //! Wakes up waiting threads with byte array.
+    bool notify(const std::uint8_t * raw, std::size_t len, std::uint32_t key = ANY_KEY)
+    { return len == sizeof(T) && StateObserverBase::notify(raw, len, key); }
 };
 
 /**
@@ -142,14 +192,17 @@ class TypedStateObserver<std::uint8_t[]> final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
+    using StateObserverBase::setTimeout;
+    using StateObserverBase::ANY_KEY;
 
     //! Wait with timeout until another thread invokes @ref notify.
-    bool await(std::uint8_t * raw)
-    { return StateObserverBase::await(raw); }
+    bool await(std::uint8_t * raw, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::await(raw, key); }
 
-    //! Wakes up a waiting thread.
-    bool notify(const std::uint8_t * raw, std::size_t len)
-    { return StateObserverBase::notify(raw, len); }
+    //! Wakes up waiting threads.
+    bool notify(const std::uint8_t * raw, std::size_t len, std::uint32_t key = ANY_KEY)
+    { return StateObserverBase::notify(raw, len, key); }
 };
 
 } // namespace roboticslab
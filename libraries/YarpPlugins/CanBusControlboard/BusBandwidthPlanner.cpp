@@ -0,0 +1,115 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "BusBandwidthPlanner.hpp"
+
+#include <cmath>
+
+#include <ColorDebug.h>
+
+#include "CanUtils.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    constexpr unsigned int MAX_DIVISOR = 240; // CiA 301, synchronous cyclic transmission types
+}
+
+// -----------------------------------------------------------------------------
+
+BusBandwidthPlanner::BusBandwidthPlanner(double _syncPeriod, unsigned int _bitrate, bool syncCounter)
+    : syncPeriod(_syncPeriod),
+      bitrate(_bitrate),
+      syncLength(CanUtils::getFrameLength(syncCounter ? 1 : 0))
+{ }
+
+// -----------------------------------------------------------------------------
+
+void BusBandwidthPlanner::addNode(ICanBusSharer * node)
+{
+    for (const auto & frame : node->getCyclicFrames())
+    {
+        entries.push_back({node, frame});
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+double BusBandwidthPlanner::getBitsPerCycle() const
+{
+    double bits = syncLength;
+
+    for (const auto & entry : entries)
+    {
+        bits += CanUtils::getFrameLength(entry.frame.len) * entry.frame.rate;
+    }
+
+    return bits;
+}
+
+// -----------------------------------------------------------------------------
+
+double BusBandwidthPlanner::getUtilization() const
+{
+    return getBitsPerCycle() / (bitrate * syncPeriod);
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned int BusBandwidthPlanner::relax(double maxUtilization)
+{
+    if (getUtilization() <= maxUtilization)
+    {
+        return 1;
+    }
+
+    double limit = maxUtilization * bitrate * syncPeriod;
+    double fixedBits = syncLength;
+    double relaxedBits = 0.0; // assuming one frame per cycle
+
+    for (const auto & entry : entries)
+    {
+        unsigned int length = CanUtils::getFrameLength(entry.frame.len);
+
+        if (entry.frame.relaxed)
+        {
+            relaxedBits += length;
+        }
+        else
+        {
+            fixedBits += length * entry.frame.rate;
+        }
+    }
+
+    if (relaxedBits == 0.0 || fixedBits >= limit)
+    {
+        return 0;
+    }
+
+    unsigned int divisor = std::ceil(relaxedBits / (limit - fixedBits));
+
+    if (divisor > MAX_DIVISOR)
+    {
+        return 0;
+    }
+
+    for (auto & entry : entries)
+    {
+        if (entry.frame.relaxed)
+        {
+            if (!entry.node->setCyclicDivisor(entry.frame.cobId, divisor))
+            {
+                CD_WARNING("Unable to send COB-ID 0x%03X every %u SYNC cycles.\n", entry.frame.cobId, divisor);
+                continue;
+            }
+
+            entry.frame.rate = 1.0 / divisor;
+        }
+    }
+
+    return getUtilization() <= maxUtilization ? divisor : 0;
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __BUS_BANDWIDTH_PLANNER_HPP__
+#define __BUS_BANDWIDTH_PLANNER_HPP__
+
+#include <vector>
+
+#include "ICanBusSharer.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Worst-case bandwidth budget of a CAN bus over a SYNC cycle.
+ *
+ * Collects the periodic frames announced by the nodes of a bus and computes
+ * the worst-case number of bits on the wire per SYNC cycle, stuff bits and the
+ * SYNC message included. Event-driven frames without inhibit time have no such
+ * bound, their typical load is accounted for instead. Synchronous frames that
+ * carry slow-changing data can be assigned a common SYNC divisor, so that the
+ * remaining traffic keeps its full rate.
+ */
+class BusBandwidthPlanner final
+{
+public:
+    //! Constructor.
+    BusBandwidthPlanner(double syncPeriod, unsigned int bitrate, bool syncCounter);
+
+    //! Register periodic frames of a node.
+    void addNode(ICanBusSharer * node);
+
+    //! Worst-case number of bits per SYNC cycle.
+    double getBitsPerCycle() const;
+
+    //! Worst-case fraction of the bitrate used per SYNC cycle.
+    double getUtilization() const;
+
+    //! Number of registered frames.
+    unsigned int getFrames() const
+    { return entries.size(); }
+
+    /**
+     * @brief Assign the lowest SYNC divisor to relaxed frames that fits the limit.
+     * @return Applied divisor (1 if no change is needed), 0 if the limit cannot be met.
+     */
+    unsigned int relax(double maxUtilization);
+
+private:
+    struct Entry
+    {
+        ICanBusSharer * node;
+        CyclicFrame frame;
+    };
+
+    double syncPeriod;
+    unsigned int bitrate;
+    unsigned int syncLength;
+    std::vector<Entry> entries;
+};
+
+} // namespace roboticslab
+
+#endif // __BUS_BANDWIDTH_PLANNER_HPP__
@@ -2,26 +2,15 @@
 
 #include "BusLoadMonitor.hpp"
 
-#include <cmath>
+#include "CanUtils.hpp"
 
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
 
-namespace
-{
-    inline unsigned long computeLength(unsigned int len)
-    {
-        // 44-bit base frame + 3-bit intermission field + stuff bits, see https://w.wiki/GDt
-        return 8 * len + 44 + std::floor((34 + 8 * len - 1) / 4.0) + 3;
-    }
-}
-
-// -----------------------------------------------------------------------------
-
 bool OneWayMonitor::notifyMessage(const can_message & msg)
 {
-    bits += computeLength(msg.len);
+    bits += CanUtils::getFrameLength(msg.len);
     return true;
 }
 
@@ -19,21 +19,49 @@ CanBusBroker::CanBusBroker(const std::string & _name)
       iCanBus(nullptr),
       iCanBusErrors(nullptr),
       iCanBufferFactory(nullptr),
-      busLoadMonitor(nullptr)
+      bitrate(0),
+      busLoadMonitor(nullptr),
+      syncProducer(nullptr),
+      syncMonitor(nullptr),
+      mpdoProducer(nullptr),
+      timeProducer(nullptr),
+      timeTimer(nullptr),
+      nmtMaster(nullptr),
+      nodeScanner(nullptr),
+      lssProbeTimeout(0.0),
+      emcyJournal(nullptr),
+      emcyTimer(nullptr),
+      heartbeatConsumer(nullptr),
+      heartbeatTimer(nullptr),
+      recoveryThread(nullptr)
 { }
 
 // -----------------------------------------------------------------------------
 
 CanBusBroker::~CanBusBroker()
 {
+    stopHeartbeatMonitor();
     stopThreads();
 
     dumpPort.close();
     sendPort.close();
     sdoPort.close();
     busLoadPort.close();
+    emcyPort.close();
 
     delete busLoadMonitor;
+    delete syncMonitor;
+    delete syncProducer;
+    delete mpdoProducer;
+    delete timeTimer;
+    delete timeProducer;
+    delete nmtMaster;
+    delete nodeScanner;
+    delete emcyTimer;
+    delete emcyJournal;
+    delete heartbeatTimer;
+    delete recoveryThread;
+    delete heartbeatConsumer;
     delete readerThread;
     delete writerThread;
 }
@@ -70,6 +98,164 @@ bool CanBusBroker::configure(const yarp::os::Searchable & config)
     readerThread = new CanReaderThread(name, rxDelay, rxBufferSize);
     writerThread = new CanWriterThread(name, txDelay, txBufferSize);
 
+    syncProducer = new SyncProducer(writerThread->getDelegate());
+
+    if (config.check("syncOverflow", "SYNC counter overflow value, [2-240] (0: no counter)")
+        && !syncProducer->setCounterOverflow(config.find("syncOverflow").asInt32()))
+    {
+        return false;
+    }
+
+    syncMonitor = new SyncCycleMonitor(*syncProducer);
+    readerThread->attachSyncMonitor(syncMonitor);
+
+    if (config.check("mpdoCobId", "COB-ID of DAM-MPDO setpoints sent on each SYNC cycle"))
+    {
+        int mpdoCobId = config.find("mpdoCobId").asInt32();
+
+        if (mpdoCobId <= 0 || mpdoCobId > 0x7FF)
+        {
+            CD_WARNING("Illegal MPDO COB-ID: %d.\n", mpdoCobId);
+            return false;
+        }
+
+        mpdoProducer = new MpdoProducer(mpdoCobId, writerThread->getDelegate());
+    }
+
+    if (config.check("timePeriod", "TIME message period (seconds)"))
+    {
+        double timePeriod = config.find("timePeriod").asFloat64();
+
+        if (timePeriod <= 0.0)
+        {
+            CD_WARNING("Illegal TIME period: %f.\n", timePeriod);
+            return false;
+        }
+
+        timeProducer = new TimeProducer(writerThread->getDelegate());
+
+        timeTimer = new yarp::os::Timer(yarp::os::TimerSettings(timePeriod),
+            [this](const yarp::os::YarpTimerEvent & event)
+            {
+                timeProducer->sendTime();
+                return true;
+            },
+            true);
+    }
+
+    if (config.check("nmtBroadcast", yarp::os::Value(false), "start/reset all nodes with broadcast NMT commands").asBool())
+    {
+        double nmtTimeout = config.check("nmtTimeout", yarp::os::Value(2.0), "NMT state confirmation timeout (seconds)").asFloat64();
+        nmtMaster = new NmtMaster(nmtTimeout, writerThread->getDelegate());
+        readerThread->attachCanNotifier(nmtMaster);
+    }
+
+    if (config.check("scanTimeout", "node presence scan timeout (seconds)"))
+    {
+        double scanTimeout = config.find("scanTimeout").asFloat64();
+
+        if (scanTimeout <= 0.0)
+        {
+            CD_WARNING("Illegal node presence scan timeout: %f.\n", scanTimeout);
+            return false;
+        }
+
+        nodeScanner = new NodeScanner(scanTimeout, writerThread->getDelegate());
+        readerThread->attachCanNotifier(nodeScanner);
+
+        lssProbeTimeout = config.check("lssProbeTimeout", yarp::os::Value(0.0),
+                "LSS fastscan probe timeout (seconds), 0 to disable").asFloat64();
+    }
+
+    if (config.check("monitorPeriod", "heartbeat monitor period (seconds)"))
+    {
+        double monitorPeriod = config.find("monitorPeriod").asFloat64();
+
+        if (monitorPeriod <= 0.0)
+        {
+            CD_WARNING("Illegal heartbeat monitor period: %f.\n", monitorPeriod);
+            return false;
+        }
+
+        heartbeatConsumer = new HeartbeatConsumer(monitorPeriod);
+
+        heartbeatConsumer->registerLostHandler([this](std::uint8_t id, double elapsed)
+            {
+                CD_ERROR("Last heartbeat response was %f seconds ago (canId %d).\n", elapsed, id);
+                auto it = readerThread->getHandleMap().find(id);
+
+                if (it != readerThread->getHandleMap().end())
+                {
+                    it->second->notifyHeartbeatLost();
+                }
+            });
+
+        recoveryThread = new NodeRecoveryThread;
+
+        // recovery requires confirmed transfers, don't hold back deadline checks of other nodes
+        heartbeatConsumer->registerBootUpHandler([this](std::uint8_t id)
+            {
+                auto it = readerThread->getHandleMap().find(id);
+
+                if (it != readerThread->getHandleMap().end())
+                {
+                    recoveryThread->request(it->second);
+                }
+            });
+
+        readerThread->attachCanNotifier(heartbeatConsumer);
+
+        heartbeatTimer = new yarp::os::Timer(yarp::os::TimerSettings(monitorPeriod),
+            [this](const yarp::os::YarpTimerEvent & event)
+            {
+                heartbeatConsumer->check();
+                return true;
+            },
+            true);
+    }
+
+    if (config.check("emcyPeriod", "EMCY journal drain period (seconds)"))
+    {
+        double emcyPeriod = config.find("emcyPeriod").asFloat64();
+        int emcyJournalSize = config.check("emcyJournalSize", yarp::os::Value(256), "EMCY journal capacity").asInt32();
+
+        if (emcyPeriod <= 0.0 || emcyJournalSize <= 0)
+        {
+            CD_WARNING("Illegal EMCY journal options.\n");
+            return false;
+        }
+
+        emcyJournal = new EmcyJournal(emcyJournalSize);
+        readerThread->attachEmcyJournal(emcyJournal);
+
+        emcyTimer = new yarp::os::Timer(yarp::os::TimerSettings(emcyPeriod),
+            [this](const yarp::os::YarpTimerEvent & event)
+            {
+                emcyJournal->drain([this](const can_message & msg)
+                    {
+                        auto it = readerThread->getHandleMap().find(msg.id & 0x7F);
+
+                        if (it != readerThread->getHandleMap().end())
+                        {
+                            it->second->notifyMessage(msg);
+                        }
+
+                        if (emcyPort.isOpen() && msg.len == 8)
+                        {
+                            yarp::os::Bottle & b = emcyWriter.prepare();
+                            b.clear();
+                            b.addInt32(msg.id & 0x7F);
+                            b.addInt32(msg.data[0] + (msg.data[1] << 8)); // error code
+                            b.addInt32(msg.data[2]); // error register
+                            emcyWriter.write();
+                        }
+                    });
+
+                return true;
+            },
+            true);
+    }
+
     if (config.check("name", "YARP port prefix for remote CAN interface"))
     {
         return createPorts(config.find("name").asString());
@@ -100,16 +286,18 @@ bool CanBusBroker::registerDevice(yarp::dev::PolyDriver * driver)
         return false;
     }
 
-    if (busLoadMonitor)
+    if (!iCanBus->canGetBaudRate(&bitrate))
     {
-        unsigned int bitrate;
+        bitrate = 0;
 
-        if (!iCanBus->canGetBaudRate(&bitrate))
+        if (busLoadMonitor)
         {
             CD_WARNING("Cannot get bitrate.\n");
             return false;
         }
-
+    }
+    else if (busLoadMonitor)
+    {
         busLoadMonitor->setBitrate(bitrate);
     }
 
@@ -183,6 +371,18 @@ bool CanBusBroker::createPorts(const std::string & prefix)
         busLoadMonitor->attach(busLoadPort);
     }
 
+    if (emcyJournal)
+    {
+        if (!emcyPort.open(prefix + "/emcy:o"))
+        {
+            CD_WARNING("Cannot open EMCY port.\n");
+            return false;
+        }
+
+        emcyPort.setInputMode(false);
+        emcyWriter.attach(emcyPort);
+    }
+
     return true;
 }
 
@@ -228,6 +428,35 @@ bool CanBusBroker::clearFilters()
 
 // -----------------------------------------------------------------------------
 
+bool CanBusBroker::scanNodes()
+{
+    if (!nodeScanner)
+    {
+        return true;
+    }
+
+    bool ok = nodeScanner->scan();
+
+    for (auto id : nodeScanner->getAbsentNodes())
+    {
+        CD_WARNING("Node %d did not respond on %s.\n", id, name.c_str());
+    }
+
+    if (lssProbeTimeout > 0.0)
+    {
+        // responses on 7E4h might be dropped if acceptance filters are enabled
+        for (const auto & address : nodeScanner->fastscan(lssProbeTimeout))
+        {
+            CD_WARNING("Unconfigured LSS node on %s: vendor 0x%08x, product 0x%08x, revision 0x%08x, serial 0x%08x.\n",
+                    name.c_str(), address[0], address[1], address[2], address[3]);
+        }
+    }
+
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+
 bool CanBusBroker::startThreads()
 {
     if (busLoadMonitor && !busLoadMonitor->start())
@@ -248,11 +477,45 @@ bool CanBusBroker::startThreads()
         return false;
     }
 
+    if (timeTimer && !timeTimer->start())
+    {
+        CD_WARNING("Cannot start TIME producer timer.\n");
+        return false;
+    }
+
+    if (emcyTimer && !emcyTimer->start())
+    {
+        CD_WARNING("Cannot start EMCY journal timer.\n");
+        return false;
+    }
+
     return true;
 }
 
 // -----------------------------------------------------------------------------
 
+bool CanBusBroker::startHeartbeatMonitor()
+{
+    return !heartbeatTimer || (recoveryThread->start() && heartbeatTimer->start());
+}
+
+// -----------------------------------------------------------------------------
+
+void CanBusBroker::stopHeartbeatMonitor()
+{
+    if (heartbeatTimer && heartbeatTimer->isRunning())
+    {
+        heartbeatTimer->stop();
+    }
+
+    if (recoveryThread && recoveryThread->isRunning())
+    {
+        recoveryThread->stop();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 bool CanBusBroker::stopThreads()
 {
     sendPort.interrupt();
@@ -264,6 +527,16 @@ bool CanBusBroker::stopThreads()
         busLoadMonitor->stop();
     }
 
+    if (timeTimer && timeTimer->isRunning())
+    {
+        timeTimer->stop();
+    }
+
+    if (emcyTimer && emcyTimer->isRunning())
+    {
+        emcyTimer->stop();
+    }
+
     bool ok = true;
 
     if (readerThread && readerThread->isRunning() && !readerThread->stop())
@@ -281,6 +554,7 @@ bool CanBusBroker::stopThreads()
     // keep out ports last to avoid deadlock (happened sometimes with dumpPort)
     dumpPort.interrupt();
     busLoadPort.interrupt();
+    emcyPort.interrupt();
 
     return ok;
 }
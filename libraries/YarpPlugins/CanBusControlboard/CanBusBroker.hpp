@@ -12,6 +12,7 @@
 #include <yarp/os/PortWriterBuffer.h>
 #include <yarp/os/RpcServer.h>
 #include <yarp/os/Searchable.h>
+#include <yarp/os/Timer.h>
 #include <yarp/os/TypedReaderCallback.h>
 
 #include <yarp/dev/CanBusInterface.h>
@@ -20,6 +21,15 @@
 #include "CanRxTxThreads.hpp"
 #include "SdoReplier.hpp"
 #include "BusLoadMonitor.hpp"
+#include "NmtMaster.hpp"
+#include "NodeScanner.hpp"
+#include "EmcyJournal.hpp"
+#include "MpdoProtocol.hpp"
+#include "HeartbeatConsumer.hpp"
+#include "NodeRecoveryThread.hpp"
+#include "SyncProducer.hpp"
+#include "SyncCycleMonitor.hpp"
+#include "TimeProducer.hpp"
 
 namespace roboticslab
 {
@@ -35,6 +45,23 @@ namespace roboticslab
  * CAN traffic is interfaced via optional YARP ports to allow remote access.
  * This includes an output dump port, an input command port, and an RPC service
  * for confirmed SDO transfers.
+ *
+ * Heartbeats of all nodes on this bus can be supervised by a single consumer
+ * and timer, which notify the corresponding node on missed deadlines. Boot-up
+ * events are handed over to a worker thread that recovers the node.
+ *
+ * SYNC messages are sent through a producer that optionally appends a cycle
+ * counter. Setpoints staged by the nodes during a cycle may be packed into
+ * multiplexed PDOs right before SYNC. Synchronous PDOs are tagged with the cycle they arrived in, missed,
+ * duplicated and late cycles are counted per node. If enabled, the host time is
+ * periodically broadcast through the TIME object.
+ *
+ * EMCY messages can be diverted to a journal, which is drained by a timer that
+ * forwards them to their nodes and publishes them through an output port.
+ *
+ * Before initialization, all nodes can be pinged at once in order to tell
+ * absent ones apart within a single timeout window. Unconfigured nodes are
+ * optionally reported through LSS fastscan.
  */
 class CanBusBroker final : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
 {
@@ -71,6 +98,51 @@ public:
     CanWriterThread * getWriter() const
     { return writerThread; }
 
+    //! Start periodic heartbeat checks, if enabled.
+    bool startHeartbeatMonitor();
+
+    //! Stop periodic heartbeat checks, if enabled.
+    void stopHeartbeatMonitor();
+
+    //! Get handle of the bus-wide heartbeat consumer, if enabled.
+    HeartbeatConsumer * getHeartbeatConsumer() const
+    { return heartbeatConsumer; }
+
+    //! Get handle of the SYNC producer.
+    SyncProducer * getSyncProducer() const
+    { return syncProducer; }
+
+    //! Get handle of the MPDO setpoint producer, if enabled.
+    MpdoProducer * getMpdoProducer() const
+    { return mpdoProducer; }
+
+    //! Get handle of the TIME producer, if enabled.
+    TimeProducer * getTimeProducer() const
+    { return timeProducer; }
+
+    //! Get handle of the SYNC cycle monitor.
+    SyncCycleMonitor * getSyncMonitor() const
+    { return syncMonitor; }
+
+    //! Get handle of the EMCY journal, if enabled.
+    EmcyJournal * getEmcyJournal() const
+    { return emcyJournal; }
+
+    //! Get handle of the bus-wide NMT master, if enabled.
+    NmtMaster * getNmtMaster() const
+    { return nmtMaster; }
+
+    //! Get handle of the node presence scanner, if enabled.
+    NodeScanner * getNodeScanner() const
+    { return nodeScanner; }
+
+    //! Scan for present and unconfigured nodes, if enabled.
+    bool scanNodes();
+
+    //! Retrieve bitrate of the registered CAN device (0 if unknown).
+    unsigned int getBitrate() const
+    { return bitrate; }
+
     //! Retrieve string identifier for this CAN bus.
     std::string getName() const
     { return name; }
@@ -91,6 +163,8 @@ private:
     yarp::dev::ICanBusErrors * iCanBusErrors;
     yarp::dev::ICanBufferFactory * iCanBufferFactory;
 
+    unsigned int bitrate;
+
     yarp::os::Port dumpPort;
     yarp::os::PortWriterBuffer<yarp::os::Bottle> dumpWriter;
     std::mutex dumpMutex;
@@ -103,6 +177,27 @@ private:
 
     yarp::os::Port busLoadPort;
     BusLoadMonitor * busLoadMonitor;
+
+    SyncProducer * syncProducer;
+    SyncCycleMonitor * syncMonitor;
+    MpdoProducer * mpdoProducer;
+
+    TimeProducer * timeProducer;
+    yarp::os::Timer * timeTimer;
+
+    NmtMaster * nmtMaster;
+
+    NodeScanner * nodeScanner;
+    double lssProbeTimeout;
+
+    EmcyJournal * emcyJournal;
+    yarp::os::Timer * emcyTimer;
+    yarp::os::Port emcyPort;
+    yarp::os::PortWriterBuffer<yarp::os::Bottle> emcyWriter;
+
+    HeartbeatConsumer * heartbeatConsumer;
+    yarp::os::Timer * heartbeatTimer;
+    NodeRecoveryThread * recoveryThread;
 };
 
 } // namespace roboticslab
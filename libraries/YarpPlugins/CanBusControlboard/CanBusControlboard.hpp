@@ -5,12 +5,12 @@
 
 #include <vector>
 
-#include <yarp/os/Timer.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 
 #include "FutureTask.hpp"
 #include "DeviceMapper.hpp"
 #include "CanBusBroker.hpp"
+#include "SyncThread.hpp"
 
 #define CHECK_JOINT(j) do { int n = deviceMapper.getControlledAxes(); if ((j) < 0 || (j) > n - 1) return false; } while (0)
 
@@ -58,7 +58,7 @@ class CanBusControlboard : public yarp::dev::DeviceDriver,
                            public yarp::dev::IVelocityControl
 {
 public:
-    CanBusControlboard() : syncTimer(nullptr), taskFactory(nullptr)
+    CanBusControlboard() : syncThread(nullptr), taskFactory(nullptr), startSkewMeter(nullptr)
     { }
 
     ~CanBusControlboard()
@@ -309,14 +309,20 @@ public:
     //virtual bool stop(int n_joint, const int *joints) override;
 
 private:
+    //! Issue commands on several joints within a single SYNC cycle if coordinated start is enabled (all nodes only stage setpoints).
+    template<typename Fn>
+    bool coordinate(Fn && fn)
+    { return startSkewMeter && syncThread ? syncThread->withinCycle(fn) : fn(); }
+
     DeviceMapper deviceMapper;
 
     std::vector<yarp::dev::PolyDriver *> busDevices;
     std::vector<yarp::dev::PolyDriver *> nodeDevices;
     std::vector<CanBusBroker *> canBusBrokers;
 
-    yarp::os::Timer * syncTimer;
+    SyncThread * syncThread;
     FutureTaskFactory * taskFactory;
+    StartSkewMeter * startSkewMeter;
 };
 
 } // namespace roboticslab
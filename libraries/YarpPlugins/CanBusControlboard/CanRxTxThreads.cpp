@@ -61,7 +61,8 @@ void CanReaderWriterThread::dumpMessage(const can_message & msg)
 
 CanReaderThread::CanReaderThread(const std::string & id, double delay, unsigned int bufferSize)
     : CanReaderWriterThread("read", id, delay, bufferSize),
-      canMessageNotifier(nullptr)
+      syncMonitor(nullptr),
+      emcyJournal(nullptr)
 { }
 
 // -----------------------------------------------------------------------------
@@ -70,6 +71,11 @@ void CanReaderThread::registerHandle(ICanBusSharer * p)
 {
     canIdToHandle[p->getId()] = p;
 
+    if (p->isCanOpenNode())
+    {
+        emcyProducers.insert(p->getId());
+    }
+
     for (auto id : p->getAdditionalIds())
     {
         canIdToHandle[id] = p;
@@ -98,11 +104,45 @@ void CanReaderThread::run()
         for (int i = 0; i < read; i++)
         {
             can_message msg {canBuffer[i].getId(), canBuffer[i].getLen(), canBuffer[i].getData()};
-            auto it = canIdToHandle.find(msg.id & 0x7F);
 
-            if (it != canIdToHandle.end())
+            //-- Assign cycle first, so that handlers can query it.
+            if (syncMonitor)
+            {
+                syncMonitor->notifyMessage(msg);
+            }
+
+            ICanBusSharer * handle = nullptr;
+
+            //-- Reassigned COB-IDs take precedence, their lower bits do not identify the node.
+            if (!cobIdToHandle.empty())
+            {
+                auto it = cobIdToHandle.find(msg.id);
+
+                if (it != cobIdToHandle.end())
+                {
+                    handle = it->second;
+                }
+            }
+
+            if (!handle)
+            {
+                auto it = canIdToHandle.find(msg.id & 0x7F);
+
+                if (it != canIdToHandle.end())
+                {
+                    handle = it->second;
+                }
+            }
+
+            //-- Defer EMCY handling, the journal is drained by a lower priority thread.
+            //-- Other devices may use the same range, e.g. absolute encoders in push mode.
+            if (emcyJournal && (msg.id & 0x780) == 0x080 && emcyProducers.count(msg.id & 0x7F) != 0)
+            {
+                emcyJournal->notifyMessage(msg);
+            }
+            else if (handle)
             {
-                it->second->notifyMessage(msg);
+                handle->notifyMessage(msg);
             }
 
             if (dumpWriter)
@@ -110,7 +150,7 @@ void CanReaderThread::run()
                 dumpMessage(msg);
             }
 
-            if (canMessageNotifier)
+            for (auto * canMessageNotifier : canMessageNotifiers)
             {
                 canMessageNotifier->notifyMessage(msg);
             }
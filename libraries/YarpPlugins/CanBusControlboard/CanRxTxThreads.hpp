@@ -6,6 +6,8 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/PortWriterBuffer.h>
@@ -14,6 +16,8 @@
 #include <yarp/dev/CanBusInterface.h>
 
 #include "ICanBusSharer.hpp"
+#include "SyncCycleMonitor.hpp"
+#include "EmcyJournal.hpp"
 
 namespace roboticslab
 {
@@ -107,22 +111,38 @@ public:
     //! Constructor.
     CanReaderThread(const std::string & id, double delay, unsigned int bufferSize);
 
-    //! Map CAN node ids with handles.
+    //! Attach SYNC cycle monitor, synchronous PDOs are tagged before being forwarded.
+    void attachSyncMonitor(SyncCycleMonitor * syncMonitor)
+    { this->syncMonitor = syncMonitor; }
+
+    //! Attach EMCY journal, EMCY messages of CANopen nodes are stored there instead of being forwarded to handles.
+    void attachEmcyJournal(EmcyJournal * emcyJournal)
+    { this->emcyJournal = emcyJournal; }
+
+    //! Map CAN node ids with handles, keep track of EMCY producers.
     void registerHandle(ICanBusSharer * p);
 
+    //! Map a reassigned COB-ID, which may not carry the CAN node id, with its handle.
+    void registerCobId(unsigned int cobId, ICanBusSharer * p)
+    { cobIdToHandle[cobId] = p; }
+
     //! Retrieve internal map of CAN handles.
     const std::unordered_map<unsigned int, ICanBusSharer *> & getHandleMap()
     { return canIdToHandle; }
 
-    //! Attach custom CAN message responder handle.
+    //! Attach custom CAN message responder handle, all messages are forwarded to it.
     void attachCanNotifier(CanMessageNotifier * canMessageNotifier)
-    { this->canMessageNotifier = canMessageNotifier; }
+    { canMessageNotifiers.push_back(canMessageNotifier); }
 
     virtual void run() override;
 
 private:
     std::unordered_map<unsigned int, ICanBusSharer *> canIdToHandle;
-    CanMessageNotifier * canMessageNotifier;
+    std::unordered_map<unsigned int, ICanBusSharer *> cobIdToHandle;
+    std::unordered_set<unsigned int> emcyProducers;
+    std::vector<CanMessageNotifier *> canMessageNotifiers;
+    SyncCycleMonitor * syncMonitor;
+    EmcyJournal * emcyJournal;
 };
 
 /**
@@ -2,17 +2,91 @@
 
 #include "CanBusControlboard.hpp"
 
+#include <algorithm> // std::find, std::max
+#include <string>
+#include <vector>
+
 #include <yarp/os/Property.h>
 #include <yarp/os/Value.h>
 
 #include <ColorDebug.h>
 
+#include "BusBandwidthPlanner.hpp"
+#include "CobIdAllocator.hpp"
+#include "DriveStatusGroup.hpp"
 #include "ICanBusSharer.hpp"
 
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
 
+namespace
+{
+    // drives of the nodes that satisfy the predicate, in lockstep; the longest drive timeout applies to each step
+    template<typename Pred>
+    DriveStatusGroup makeDriveGroup(const std::vector<ICanBusSharer *> & handles, std::vector<ICanBusSharer *> & members, Pred && pred)
+    {
+        double timeout = 0.0;
+        std::vector<DriveStatusMachine *> drives;
+        members.clear();
+
+        for (auto * handle : handles)
+        {
+            auto * provider = dynamic_cast<IDriveStatusProvider *>(handle);
+            auto * drive = provider ? provider->getDriveStatus() : nullptr;
+
+            if (drive && pred(drive->getCurrentState()))
+            {
+                members.push_back(handle);
+                drives.push_back(drive);
+                timeout = std::max(timeout, drive->getTimeout());
+            }
+        }
+
+        DriveStatusGroup group(timeout);
+
+        for (auto * drive : drives)
+        {
+            group.add(drive);
+        }
+
+        return group;
+    }
+
+    // formerly read by each node from its own group or from "common-ipos", now the bus supervises all heartbeats
+    void forwardLegacyMonitorPeriod(const yarp::os::Property & robotConfig, const yarp::os::Value & nodesVal, yarp::os::Property & canBusOptions)
+    {
+        std::vector<std::string> groups {"common-ipos"};
+
+        if (nodesVal.isList())
+        {
+            for (int i = 0; i < nodesVal.asList()->size(); i++)
+            {
+                groups.push_back(nodesVal.asList()->get(i).asString());
+            }
+        }
+
+        for (const auto & group : groups)
+        {
+            const yarp::os::Value & legacy = robotConfig.findGroup(group).find("monitorPeriod");
+
+            if (legacy.isNull())
+            {
+                continue;
+            }
+
+            CD_WARNING("Option \"monitorPeriod\" in group %s is deprecated, set it in the CAN bus group instead.\n", group.c_str());
+
+            if (!canBusOptions.check("monitorPeriod") && legacy.asFloat64() > 0.0)
+            {
+                canBusOptions.put("monitorPeriod", legacy);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 bool CanBusControlboard::open(yarp::os::Searchable & config)
 {
     CD_DEBUG("%s\n", config.toString().c_str());
@@ -25,6 +99,25 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
 
     const auto * robotConfig = *reinterpret_cast<yarp::os::Property * const *>(config.find("robotConfig").asBlob());
 
+    int parallelMapping = config.check("parallelMapping", yarp::os::Value(0),
+            "concurrent tasks for multi-joint commands, e.g. mode switches (0: sequential)").asInt32();
+
+    if (parallelMapping > 0)
+    {
+        deviceMapper.enableParallelization(parallelMapping);
+    }
+
+    if (config.check("coordinatedStart", yarp::os::Value(false), "release multi-joint motions on a single SYNC").asBool())
+    {
+        if (!config.check("syncPeriod"))
+        {
+            CD_ERROR("Coordinated start requires \"syncPeriod\".\n");
+            return false;
+        }
+
+        startSkewMeter = new StartSkewMeter;
+    }
+
     yarp::os::Bottle * canBuses = config.find("buses").asList();
 
     if (canBuses == nullptr)
@@ -55,6 +148,21 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
             canBusOptions.put("robotConfig", config.find("robotConfig"));
             canBusOptions.put("blockingMode", false); // enforce non-blocking mode
             canBusOptions.put("allowPermissive", false); // always check usage requirements
+
+            if (config.check("syncOverflow", "SYNC counter overflow value, [2-240] (0: no counter)"))
+            {
+                canBusOptions.put("syncOverflow", config.find("syncOverflow"));
+            }
+
+            if (config.check("timePeriod", "TIME message period (seconds)"))
+            {
+                canBusOptions.put("timePeriod", config.find("timePeriod"));
+            }
+
+            if (!canBusOptions.check("monitorPeriod"))
+            {
+                forwardLegacyMonitorPeriod(*robotConfig, config.find(canBus), canBusOptions);
+            }
         }
         else
         {
@@ -121,6 +229,8 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
             }
         }
 
+        std::vector<ICanBusSharer *> handles;
+
         for (int i = 0; i < nodes.size(); i++)
         {
             std::string node = nodes.get(i).asString();
@@ -142,6 +252,25 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
                 nodeOptions.fromString(nodeGroup.toString());
                 nodeOptions.put("robotConfig", config.find("robotConfig"));
                 nodeOptions.put("syncPeriod", config.find("syncPeriod"));
+
+                // only read by CANopen node devices, the handle is not available before opening
+                if (canBusBrokers.back()->getNmtMaster())
+                {
+                    nodeOptions.put("nmtBroadcast", true);
+                }
+
+                if (canBusBrokers.back()->getMpdoProducer())
+                {
+                    // nodes opt in and register themselves, see "mpdoSetpoints"
+                    auto * mpdoProducer = canBusBrokers.back()->getMpdoProducer();
+                    nodeOptions.put("mpdoProducer", yarp::os::Value::makeBlob(&mpdoProducer, sizeof(mpdoProducer)));
+                }
+
+                if (startSkewMeter)
+                {
+                    // nodes opt in, see "coordinatedStart"
+                    nodeOptions.put("startSkewMeter", yarp::os::Value::makeBlob(&startSkewMeter, sizeof(startSkewMeter)));
+                }
             }
             else
             {
@@ -175,6 +304,122 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
 
                 canBusBrokers.back()->getReader()->registerHandle(iCanBusSharer);
                 iCanBusSharer->registerSender(canBusBrokers.back()->getWriter()->getDelegate());
+                handles.push_back(iCanBusSharer);
+
+                // other devices do not answer SDO requests nor send heartbeats
+                if (canBusBrokers.back()->getNmtMaster() && iCanBusSharer->isCanOpenNode())
+                {
+                    canBusBrokers.back()->getNmtMaster()->addNode(iCanBusSharer->getId());
+                }
+
+                if (canBusBrokers.back()->getHeartbeatConsumer() && iCanBusSharer->isCanOpenNode())
+                {
+                    canBusBrokers.back()->getHeartbeatConsumer()->addNode(iCanBusSharer->getId());
+                }
+
+                if (canBusBrokers.back()->getNodeScanner() && iCanBusSharer->isCanOpenNode())
+                {
+                    canBusBrokers.back()->getNodeScanner()->addNode(iCanBusSharer->getId());
+                }
+            }
+        }
+
+        if (!isFakeBus && config.check("cobIdPriorities", yarp::os::Value(false),
+                "reassign PDO COB-IDs across nodes by priority class").asBool())
+        {
+            CobIdAllocator allocator;
+
+            for (auto * handle : handles)
+            {
+                for (const auto & frame : handle->getCyclicFrames())
+                {
+                    if (frame.priority >= 0)
+                    {
+                        allocator.request(frame.cobId, frame.priority);
+                    }
+                }
+            }
+
+            if (!allocator.allocate())
+            {
+                CD_ERROR("Unable to allocate COB-IDs in %s.\n", canBus.c_str());
+                return false;
+            }
+
+            for (auto * handle : handles)
+            {
+                for (const auto & frame : handle->getCyclicFrames())
+                {
+                    unsigned int cobId = allocator.getCobId(frame.cobId);
+
+                    if (frame.priority < 0 || cobId == frame.cobId)
+                    {
+                        continue;
+                    }
+
+                    if (!handle->remapCobId(frame.cobId, cobId))
+                    {
+                        CD_ERROR("Unable to reassign COB-ID 0x%03X to 0x%03X (canId: %d).\n", frame.cobId, cobId, handle->getId());
+                        return false;
+                    }
+
+                    canBusBrokers.back()->getReader()->registerCobId(cobId, handle);
+                }
+            }
+        }
+
+        if (!isFakeBus && config.check("syncPeriod") && canBusBrokers.back()->getBitrate() != 0)
+        {
+            auto * canBusBroker = canBusBrokers.back();
+
+            BusBandwidthPlanner planner(config.find("syncPeriod").asFloat64(), canBusBroker->getBitrate(),
+                    canBusBroker->getSyncProducer()->getCounterOverflow() != 0);
+
+            for (auto * handle : handles)
+            {
+                planner.addNode(handle);
+            }
+
+            double maxBusLoad = config.check("maxBusLoad", yarp::os::Value(0.8), "maximum worst-case bus load per SYNC cycle, (0-1]").asFloat64();
+            bool strictBusLoad = config.check("strictBusLoad", yarp::os::Value(false), "fail if the bus load limit is exceeded").asBool();
+            bool autoPdoDivisors = config.check("autoPdoDivisors", yarp::os::Value(false),
+                    "send slow-changing PDOs every N SYNC cycles if the bus load limit is exceeded").asBool();
+
+            double busLoad = planner.getUtilization();
+
+            CD_INFO("Worst-case load of %s: %f (%.0f bits per SYNC cycle, %u periodic frames).\n", canBus.c_str(), busLoad,
+                    planner.getBitsPerCycle(), planner.getFrames());
+
+            if (busLoad > maxBusLoad)
+            {
+                unsigned int divisor = autoPdoDivisors ? planner.relax(maxBusLoad) : 0;
+
+                if (divisor != 0)
+                {
+                    CD_INFO("Slow-changing PDOs of %s sent every %u SYNC cycles, worst-case load: %f.\n", canBus.c_str(), divisor,
+                            planner.getUtilization());
+                }
+                else if (strictBusLoad)
+                {
+                    CD_ERROR("Worst-case load of %s exceeds limit: %f.\n", canBus.c_str(), maxBusLoad);
+                    return false;
+                }
+                else
+                {
+                    CD_WARNING("Worst-case load of %s exceeds limit: %f.\n", canBus.c_str(), maxBusLoad);
+                }
+            }
+        }
+
+        // after PDO divisors are assigned, relaxed frames are no longer expected on every cycle
+        if (auto * syncMonitor = canBusBrokers.back()->getSyncMonitor())
+        {
+            for (auto * handle : handles)
+            {
+                for (auto cobId : handle->getSyncPdoIds())
+                {
+                    syncMonitor->addPdo(handle->getId(), cobId);
+                }
             }
         }
 
@@ -188,6 +433,21 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
         }
     }
 
+    if (startSkewMeter)
+    {
+        for (const auto & t : deviceMapper.getDevicesWithOffsets())
+        {
+            auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
+
+            // batches are serialized with SYNC, blocking transfers of other nodes would stall the cycle
+            if (!iCanBusSharer || !startSkewMeter->isEnrolled(iCanBusSharer->getId()))
+            {
+                CD_ERROR("Coordinated start requires all nodes to enable \"coordinatedStart\".\n");
+                return false;
+            }
+        }
+    }
+
     for (auto * canBusBroker : canBusBrokers)
     {
         if (!canBusBroker->startThreads())
@@ -197,14 +457,138 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
         }
     }
 
+    // ping all nodes of each bus at once, absent nodes are not worth a timeout each
+    std::vector<ICanBusSharer *> absent;
+
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        if (canBusBroker->scanNodes())
+        {
+            continue;
+        }
+
+        // several ids may map to the same handle, e.g. an external encoder attached to a drive
+        for (const auto & entry : canBusBroker->getReader()->getHandleMap())
+        {
+            auto * handle = entry.second;
+
+            if (handle->isCanOpenNode()
+                && !canBusBroker->getNodeScanner()->isPresent(handle->getId())
+                && std::find(absent.begin(), absent.end(), handle) == absent.end())
+            {
+                absent.push_back(handle);
+            }
+        }
+    }
+
+    std::vector<ICanBusSharer *> initialized;
+
     for (const auto & t : deviceMapper.getDevicesWithOffsets())
     {
         auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
 
-        if (!iCanBusSharer->initialize())
+        if (std::find(absent.begin(), absent.end(), iCanBusSharer) != absent.end())
+        {
+            CD_ERROR("Node device id %d is absent, skipping initialization.\n", iCanBusSharer->getId());
+        }
+        else if (!iCanBusSharer->initialize())
         {
             CD_ERROR("Node device id %d could not initialize CAN comms.\n", iCanBusSharer->getId());
         }
+        else
+        {
+            initialized.push_back(iCanBusSharer);
+        }
+    }
+
+    // start all nodes of each bus with a single NMT frame, then let them complete their initialization
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        auto * nmtMaster = canBusBroker->getNmtMaster();
+
+        if (nmtMaster && !nmtMaster->issueServiceCommand(NmtService::START_REMOTE_NODE))
+        {
+            CD_ERROR("Unable to start nodes in %s.\n", canBusBroker->getName().c_str());
+        }
+    }
+
+    // node state confirmations other than boot-up require heartbeats
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        auto * nmtMaster = canBusBroker->getNmtMaster();
+
+        if (nmtMaster && canBusBroker->getHeartbeatConsumer() && !nmtMaster->awaitState(NmtState::OPERATIONAL))
+        {
+            for (auto id : nmtMaster->getFailures())
+            {
+                CD_WARNING("Node device id %d did not report operational state.\n", id);
+            }
+        }
+    }
+
+    std::vector<ICanBusSharer *> started;
+
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        if (!canBusBroker->getNmtMaster())
+        {
+            continue;
+        }
+
+        for (auto id : canBusBroker->getNmtMaster()->getNodes())
+        {
+            auto * iCanBusSharer = canBusBroker->getReader()->getHandleMap().at(id);
+
+            if (std::find(initialized.begin(), initialized.end(), iCanBusSharer) != initialized.end()
+                    && std::find(started.begin(), started.end(), iCanBusSharer) == started.end())
+            {
+                started.push_back(iCanBusSharer);
+            }
+        }
+    }
+
+    // switch on all drives at once, start() takes care of those left behind
+    std::vector<ICanBusSharer *> members;
+    auto switchOnGroup = makeDriveGroup(started, members, [](DriveState state) { return state == DriveState::SWITCH_ON_DISABLED; });
+
+    if (!switchOnGroup.requestState(DriveState::SWITCHED_ON))
+    {
+        for (auto i : switchOnGroup.getFailures())
+        {
+            CD_WARNING("Node device id %d could not switch on along with the other drives.\n", members[i]->getId());
+        }
+    }
+
+    // drive state transitions are awaited per node, let them run concurrently
+    if (!started.empty())
+    {
+        ParallelTaskFactory startFactory(started.size());
+        auto task = startFactory.createTask();
+
+        for (auto * iCanBusSharer : started)
+        {
+            task->add([iCanBusSharer]
+                {
+                    if (!iCanBusSharer->start())
+                    {
+                        CD_ERROR("Node device id %d could not start CAN comms.\n", iCanBusSharer->getId());
+                        return false;
+                    }
+
+                    return true;
+                });
+        }
+
+        task->dispatch();
+    }
+
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        if (!canBusBroker->startHeartbeatMonitor())
+        {
+            CD_ERROR("Unable to start heartbeat monitor in %s.\n", canBusBroker->getName().c_str());
+            return false;
+        }
     }
 
     if (config.check("syncPeriod", "SYNC message period (s)"))
@@ -221,36 +605,24 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
             taskFactory = new SequentialTaskFactory;
         }
 
-        syncTimer = new yarp::os::Timer(yarp::os::TimerSettings(syncPeriod),
-            [this](const yarp::os::YarpTimerEvent & event)
-            {
-                auto task = taskFactory->createTask();
+        if (syncPeriod <= 0.0)
+        {
+            CD_ERROR("Illegal SYNC period: %f.\n", syncPeriod);
+            return false;
+        }
 
-                for (auto * canBusBroker : canBusBrokers)
-                {
-                    task->add([canBusBroker]
-                        {
-                            auto * reader = canBusBroker->getReader();
-                            auto * writer = canBusBroker->getWriter();
-
-                            for (const auto & entry : reader->getHandleMap())
-                            {
-                                entry.second->synchronize();
-                            }
-
-                            writer->getDelegate()->prepareMessage({0x80, 0, nullptr}); // SYNC
-                            writer->flush();
-                            return true;
-                        });
-                }
+        double syncBudget = config.check("syncBudget", yarp::os::Value(0.5), "fraction of the SYNC period available to each bus for sending requests").asFloat64();
+
+        if (syncBudget <= 0.0 || syncBudget > 1.0)
+        {
+            CD_ERROR("Illegal SYNC budget: %f.\n", syncBudget);
+            return false;
+        }
 
-                task->dispatch();
-                return true;
-            },
-            true);
+        syncThread = new SyncThread(syncPeriod, syncBudget, canBusBrokers, taskFactory, startSkewMeter);
     }
 
-    return !syncTimer || syncTimer->start();
+    return !syncThread || syncThread->start();
 }
 
 // -----------------------------------------------------------------------------
@@ -259,17 +631,76 @@ bool CanBusControlboard::close()
 {
     bool ok = true;
 
-    if (syncTimer && syncTimer->isRunning())
+    if (syncThread)
     {
-        syncTimer->stop();
+        if (syncThread->isRunning())
+        {
+            syncThread->stop();
+        }
+
+        CD_INFO("SYNC cycles: %u, overruns: %u, period jitter: %f s (mean), %f s (max).\n", syncThread->getCycles(),
+                syncThread->getOverruns(), syncThread->getMeanJitter(), syncThread->getMaxJitter());
+
+        CD_INFO("SYNC cycles over budget: %u, max preparation time: %f s.\n", syncThread->getOverBudgetCycles(),
+                syncThread->getMaxPreparationTime());
     }
 
-    delete syncTimer;
-    syncTimer = nullptr;
+    if (startSkewMeter)
+    {
+        CD_INFO("Coordinated starts: %u (%u incomplete), start skew: %f s (mean), %f s (max).\n", startSkewMeter->getStarts(),
+                startSkewMeter->getIncompleteStarts(), startSkewMeter->getMeanSkew(), startSkewMeter->getMaxSkew());
+    }
+
+    delete syncThread;
+    syncThread = nullptr;
 
     delete taskFactory;
     taskFactory = nullptr;
 
+    // the monitor could still request CAN transfers on boot-up events
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        canBusBroker->stopHeartbeatMonitor();
+    }
+
+    std::vector<ICanBusSharer *> handles;
+
+    for (const auto & t : deviceMapper.getDevicesWithOffsets())
+    {
+        auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
+
+        if (iCanBusSharer)
+        {
+            handles.push_back(iCanBusSharer);
+        }
+    }
+
+    // stop and disable all drives at once, finalize() takes care of those left behind
+    std::vector<ICanBusSharer *> members;
+    auto quickStopGroup = makeDriveGroup(handles, members, [](DriveState state) { return state == DriveState::OPERATION_ENABLED; });
+
+    if (!quickStopGroup.requestTransition(DriveTransition::QUICK_STOP))
+    {
+        for (auto i : quickStopGroup.getFailures())
+        {
+            CD_WARNING("Node device id %d could not quick stop along with the other drives.\n", members[i]->getId());
+        }
+    }
+
+    auto disableGroup = makeDriveGroup(handles, members, [](DriveState state)
+        {
+            return state == DriveState::READY_TO_SWITCH_ON || state == DriveState::SWITCHED_ON
+                || state == DriveState::OPERATION_ENABLED || state == DriveState::QUICK_STOP_ACTIVE;
+        });
+
+    if (!disableGroup.requestState(DriveState::SWITCH_ON_DISABLED))
+    {
+        for (auto i : disableGroup.getFailures())
+        {
+            CD_WARNING("Node device id %d could not be disabled along with the other drives.\n", members[i]->getId());
+        }
+    }
+
     for (const auto & t : deviceMapper.getDevicesWithOffsets())
     {
         auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
@@ -281,8 +712,53 @@ bool CanBusControlboard::close()
         }
     }
 
+    // reset all nodes of each bus with a single NMT frame, collect boot-up messages in parallel
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        auto * nmtMaster = canBusBroker->getNmtMaster();
+
+        if (nmtMaster && !nmtMaster->issueServiceCommand(NmtService::RESET_NODE))
+        {
+            CD_WARNING("Reset node NMT service failed in %s.\n", canBusBroker->getName().c_str());
+            ok = false;
+        }
+    }
+
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        auto * nmtMaster = canBusBroker->getNmtMaster();
+
+        if (nmtMaster && !nmtMaster->awaitState(NmtState::BOOTUP))
+        {
+            for (auto id : nmtMaster->getFailures())
+            {
+                CD_WARNING("Node device id %d did not report boot-up after reset.\n", id);
+            }
+        }
+    }
+
     deviceMapper.clear();
 
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        const auto * syncMonitor = canBusBroker->getSyncMonitor();
+
+        if (!syncMonitor)
+        {
+            continue; // broker not fully configured
+        }
+
+        for (auto id : syncMonitor->getNodes())
+        {
+            if (syncMonitor->getMissedCycles(id) != 0 || syncMonitor->getDuplicatedCycles(id) != 0
+                    || syncMonitor->getLateCycles(id) != 0)
+            {
+                CD_INFO("Node device id %d SYNC cycles: %u missed, %u duplicated, %u late.\n", id,
+                        syncMonitor->getMissedCycles(id), syncMonitor->getDuplicatedCycles(id), syncMonitor->getLateCycles(id));
+            }
+        }
+    }
+
     for (auto * canBusBroker : canBusBrokers)
     {
         ok &= canBusBroker->stopThreads();
@@ -309,6 +785,10 @@ bool CanBusControlboard::close()
 
     busDevices.clear();
 
+    // nodes are gone, no more acknowledgements
+    delete startSkewMeter;
+    startSkewMeter = nullptr;
+
     return ok;
 }
 
@@ -24,7 +24,7 @@ bool CanBusControlboard::positionMove(int j, double ref)
 bool CanBusControlboard::positionMove(const double * refs)
 {
     CD_DEBUG("\n");
-    return deviceMapper.mapAllJoints(&yarp::dev::IPositionControlRaw::positionMoveRaw, refs);
+    return coordinate([&] { return deviceMapper.mapAllJoints(&yarp::dev::IPositionControlRaw::positionMoveRaw, refs); });
 }
 
 // -----------------------------------------------------------------------------
@@ -32,7 +32,7 @@ bool CanBusControlboard::positionMove(const double * refs)
 bool CanBusControlboard::positionMove(int n_joint, const int * joints, const double * refs)
 {
     CD_DEBUG("\n");
-    return deviceMapper.mapJointGroup(&yarp::dev::IPositionControlRaw::positionMoveRaw, n_joint, joints, refs);
+    return coordinate([&] { return deviceMapper.mapJointGroup(&yarp::dev::IPositionControlRaw::positionMoveRaw, n_joint, joints, refs); });
 }
 
 // -----------------------------------------------------------------------------
@@ -49,7 +49,7 @@ bool CanBusControlboard::relativeMove(int j, double delta)
 bool CanBusControlboard::relativeMove(const double * deltas)
 {
     CD_DEBUG("\n");
-    return deviceMapper.mapAllJoints(&yarp::dev::IPositionControlRaw::relativeMoveRaw, deltas);
+    return coordinate([&] { return deviceMapper.mapAllJoints(&yarp::dev::IPositionControlRaw::relativeMoveRaw, deltas); });
 }
 
 // -----------------------------------------------------------------------------
@@ -57,7 +57,7 @@ bool CanBusControlboard::relativeMove(const double * deltas)
 bool CanBusControlboard::relativeMove(int n_joint, const int * joints, const double * deltas)
 {
     CD_DEBUG("\n");
-    return deviceMapper.mapJointGroup(&yarp::dev::IPositionControlRaw::relativeMoveRaw, n_joint, joints, deltas);
+    return coordinate([&] { return deviceMapper.mapJointGroup(&yarp::dev::IPositionControlRaw::relativeMoveRaw, n_joint, joints, deltas); });
 }
 
 // -----------------------------------------------------------------------------
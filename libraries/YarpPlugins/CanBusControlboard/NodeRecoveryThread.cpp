@@ -0,0 +1,64 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "NodeRecoveryThread.hpp"
+
+#include <algorithm> // std::find
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void NodeRecoveryThread::request(ICanBusSharer * handle)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (std::find(pending.begin(), pending.end(), handle) != pending.end())
+        {
+            return;
+        }
+
+        pending.push_back(handle);
+    }
+
+    cond.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+void NodeRecoveryThread::onStop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.clear();
+    }
+
+    cond.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+void NodeRecoveryThread::run()
+{
+    while (!isStopping())
+    {
+        ICanBusSharer * handle;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] { return !pending.empty() || isStopping(); });
+
+            if (pending.empty())
+            {
+                break;
+            }
+
+            handle = pending.front();
+            pending.pop_front();
+        }
+
+        handle->notifyBootUp();
+    }
+}
+
+// -----------------------------------------------------------------------------
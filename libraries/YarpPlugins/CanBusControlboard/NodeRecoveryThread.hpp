@@ -0,0 +1,45 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __NODE_RECOVERY_THREAD_HPP__
+#define __NODE_RECOVERY_THREAD_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <yarp/os/Thread.h>
+
+#include "ICanBusSharer.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Worker thread that recovers nodes after a boot-up event.
+ *
+ * Re-initializing a node involves several confirmed SDO transfers and drive
+ * state transitions. These are queued here and processed one node at a time
+ * so that the heartbeat monitor keeps checking deadlines in the meantime.
+ */
+class NodeRecoveryThread final : public yarp::os::Thread
+{
+public:
+    //! Queue a boot-up notification for this node, duplicates are discarded.
+    void request(ICanBusSharer * handle);
+
+    //! Callback on thread stop, wakes up the worker and discards pending requests.
+    virtual void onStop() override;
+
+    //! The thread will invoke this once.
+    virtual void run() override;
+
+private:
+    std::deque<ICanBusSharer *> pending;
+    std::mutex mutex;
+    std::condition_variable cond;
+};
+
+} // namespace roboticslab
+
+#endif // __NODE_RECOVERY_THREAD_HPP__
@@ -0,0 +1,195 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SyncThread.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <functional> // std::ref
+#include <thread>
+#include <utility> // std::move
+
+#ifdef __linux__
+# include <cerrno>
+# include <ctime>
+#endif
+
+#include <ColorDebug.h>
+
+using namespace roboticslab;
+
+namespace
+{
+    using sync_clock = std::chrono::steady_clock;
+
+    void sleepUntil(const sync_clock::time_point & deadline)
+    {
+#ifdef __linux__
+        // steady_clock is backed by CLOCK_MONOTONIC, sleep to an absolute deadline
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        const timespec ts {static_cast<std::time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+SyncThread::SyncThread(double period, double budget, const std::vector<CanBusBroker *> & canBusBrokers, FutureTaskFactory * taskFactory,
+        StartSkewMeter * startSkewMeter)
+    : period(period),
+      budget(budget * period),
+      taskFactory(taskFactory),
+      startSkewMeter(startSkewMeter),
+      cycles(0),
+      overruns(0),
+      overBudget(0),
+      maxJitter(0.0),
+      sumJitter(0.0)
+{
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        BusPlan plan {canBusBroker, {}, 0.0, 0.0};
+
+        //-- The handle map also stores additional ids, keep a single entry per node.
+        for (const auto & entry : canBusBroker->getReader()->getHandleMap())
+        {
+            if (std::find(plan.handles.begin(), plan.handles.end(), entry.second) == plan.handles.end())
+            {
+                plan.handles.push_back(entry.second);
+            }
+        }
+
+        std::sort(plan.handles.begin(), plan.handles.end(), [](ICanBusSharer * a, ICanBusSharer * b)
+            { return a->getId() < b->getId(); });
+
+        plans.push_back(std::move(plan));
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+double SyncThread::getMaxPreparationTime() const
+{
+    double max = 0.0;
+
+    for (const auto & plan : plans)
+    {
+        max = std::max(max, plan.maxElapsed);
+    }
+
+    return max;
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncThread::afterStart(bool success)
+{
+    CD_INFO("Configuring CanBusControlboard SYNC thread... %s\n", success ? "success" : "failure");
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncThread::onStop()
+{
+    CD_INFO("Stopping CanBusControlboard SYNC thread.\n");
+}
+
+// -----------------------------------------------------------------------------
+
+bool SyncThread::prepare(BusPlan & plan)
+{
+    const auto start = sync_clock::now();
+
+    for (auto * handle : plan.handles)
+    {
+        handle->synchronize();
+    }
+
+    //-- Setpoints staged as MPDOs are packed once all nodes are done.
+    if (plan.canBusBroker->getMpdoProducer())
+    {
+        plan.canBusBroker->getMpdoProducer()->flush();
+    }
+
+    plan.canBusBroker->getWriter()->flush();
+
+    plan.elapsed = std::chrono::duration<double>(sync_clock::now() - start).count();
+    plan.maxElapsed = std::max(plan.maxElapsed, plan.elapsed);
+
+    return plan.elapsed <= budget;
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncThread::run()
+{
+    const auto step = std::chrono::duration_cast<sync_clock::duration>(std::chrono::duration<double>(period));
+    auto deadline = sync_clock::now() + step;
+    sync_clock::time_point previous;
+
+    while (!isStopping())
+    {
+        sleepUntil(deadline);
+
+        //-- Sample wake-up time before any work, preparation time is tracked separately.
+        const auto wakeUp = sync_clock::now();
+
+        if (cycles++ != 0)
+        {
+            const double jitter = std::abs(std::chrono::duration<double>(wakeUp - previous).count() - period);
+            sumJitter += jitter;
+
+            if (jitter > maxJitter)
+            {
+                maxJitter = jitter;
+            }
+        }
+
+        previous = wakeUp;
+
+        {
+            //-- Do not split command batches across cycles, see withinCycle().
+            std::lock_guard<std::mutex> lock(cycleMutex);
+
+            //-- Let all nodes queue their synchronous requests.
+            auto task = taskFactory->createTask();
+
+            for (auto & plan : plans)
+            {
+                task->add(this, &SyncThread::prepare, std::ref(plan));
+            }
+
+            if (!task->dispatch())
+            {
+                overBudget++;
+            }
+
+            //-- Setpoints released in this cycle take effect on the next SYNC.
+            if (startSkewMeter)
+            {
+                startSkewMeter->commit();
+            }
+
+            //-- Emit SYNC on all buses as close to each other as possible.
+            for (const auto & plan : plans)
+            {
+                plan.canBusBroker->getSyncProducer()->sendSync();
+                plan.canBusBroker->getWriter()->flush();
+            }
+        }
+
+        const auto now = sync_clock::now();
+        deadline += step;
+
+        //-- Skip deadlines that already elapsed, stay on the original time grid.
+        while (deadline <= now)
+        {
+            deadline += step;
+            overruns++;
+        }
+    }
+}
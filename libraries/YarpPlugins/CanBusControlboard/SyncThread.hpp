@@ -0,0 +1,112 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SYNC_THREAD_HPP__
+#define __SYNC_THREAD_HPP__
+
+#include <mutex>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+
+#include "FutureTask.hpp"
+#include "CanBusBroker.hpp"
+#include "StartSkewMeter.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief A thread that emits SYNC messages on all CAN buses.
+ *
+ * Cycles start at absolute deadlines on a fixed grid, so that latencies do not
+ * accumulate over time. Each cycle lets all nodes prepare their synchronous
+ * requests (optionally in parallel per bus), packs setpoints staged for the
+ * MPDO producer of each bus (if any), then sends SYNC on every bus back-to-back
+ * to keep them in phase. Wake-up jitter and overruns (cycles whose deadline had
+ * already elapsed) are recorded for later inspection.
+ *
+ * The cycle plan is built once on construction: each node is synchronized
+ * exactly once per cycle (even if it listens to additional CAN ids), in
+ * ascending order of node id. The time spent by each bus on preparing and
+ * flushing its requests is measured against a budget, expressed as a fraction
+ * of the period.
+ *
+ * Batches of commands run via @ref withinCycle never overlap with the
+ * preparation of a cycle, hence all setpoints they stage are released by the
+ * same SYNC.
+ */
+class SyncThread final : public yarp::os::Thread
+{
+public:
+    //! Constructor, task factory and skew meter are not owned by this class. Nodes must have been registered in advance.
+    SyncThread(double period, double budget, const std::vector<CanBusBroker *> & canBusBrokers, FutureTaskFactory * taskFactory,
+            StartSkewMeter * startSkewMeter = nullptr);
+
+    //! Run a batch of commands so that all of them are picked up by the same cycle.
+    template<typename Fn>
+    bool withinCycle(Fn && fn)
+    { std::lock_guard<std::mutex> lock(cycleMutex); return fn(); }
+
+    //! Number of completed cycles.
+    unsigned int getCycles() const
+    { return cycles; }
+
+    //! Number of skipped deadlines.
+    unsigned int getOverruns() const
+    { return overruns; }
+
+    //! Maximum deviation of the actual period between wake-ups (seconds).
+    double getMaxJitter() const
+    { return maxJitter; }
+
+    //! Average deviation of the actual period between wake-ups (seconds).
+    double getMeanJitter() const
+    { return cycles > 1 ? sumJitter / (cycles - 1) : 0.0; }
+
+    //! Number of cycles in which at least one bus exceeded its budget.
+    unsigned int getOverBudgetCycles() const
+    { return overBudget; }
+
+    //! Longest time a bus spent on preparing and flushing requests (seconds).
+    double getMaxPreparationTime() const;
+
+    //! Invoked by the caller after start(), logs whether the thread was started.
+    virtual void afterStart(bool success) override;
+
+    //! Callback on thread stop.
+    virtual void onStop() override;
+
+    //! The thread will invoke this once.
+    virtual void run() override;
+
+private:
+    struct BusPlan
+    {
+        CanBusBroker * canBusBroker;
+        std::vector<ICanBusSharer *> handles;
+        double elapsed; // last cycle
+        double maxElapsed;
+    };
+
+    //! Synchronize all nodes of a bus and flush requests, returns false if the budget was exceeded.
+    bool prepare(BusPlan & plan);
+
+    double period;
+    double budget;
+    std::vector<BusPlan> plans;
+    FutureTaskFactory * taskFactory;
+    StartSkewMeter * startSkewMeter;
+    std::mutex cycleMutex;
+
+    // only written by the thread, read them once it has been stopped
+    unsigned int cycles;
+    unsigned int overruns;
+    unsigned int overBudget;
+    double maxJitter;
+    double sumJitter;
+};
+
+} // namespace roboticslab
+
+#endif // __SYNC_THREAD_HPP__
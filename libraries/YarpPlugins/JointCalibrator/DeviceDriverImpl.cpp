@@ -46,12 +46,53 @@ bool JointCalibrator::open(yarp::os::Searchable & config)
         return false;
     }
 
-    return checkAndSet(axes, config, homeSpecs.pos, "home", "homes", "zero position (degrees)")
-            && checkAndSet(axes, config, homeSpecs.vel, "homeVel", "homeVels", "zero velocity (degrees/second)")
-            && checkAndSet(axes, config, homeSpecs.acc, "homeAcc", "homeAccs", "zero acceleration (degrees/second^2)")
-            && checkAndSet(axes, config, parkSpecs.pos, "park", "parks", "zero position (degrees)")
-            && checkAndSet(axes, config, parkSpecs.vel, "parkVel", "parkVels", "zero velocity (degrees/second)")
-            && checkAndSet(axes, config, parkSpecs.acc, "parkAcc", "parkAccs", "zero acceleration (degrees/second^2)");
+    if (!checkAndSet(axes, config, homeSpecs.pos, "home", "homes", "zero position (degrees)")
+            || !checkAndSet(axes, config, homeSpecs.vel, "homeVel", "homeVels", "zero velocity (degrees/second)")
+            || !checkAndSet(axes, config, homeSpecs.acc, "homeAcc", "homeAccs", "zero acceleration (degrees/second^2)")
+            || !checkAndSet(axes, config, parkSpecs.pos, "park", "parks", "zero position (degrees)")
+            || !checkAndSet(axes, config, parkSpecs.vel, "parkVel", "parkVels", "zero velocity (degrees/second)")
+            || !checkAndSet(axes, config, parkSpecs.acc, "parkAcc", "parkAccs", "zero acceleration (degrees/second^2)"))
+    {
+        return false;
+    }
+
+    // on-drive homing is optional, fall back to host-side motion on joints with no homing method
+    std::vector<double> methods;
+
+    if (config.check("homingMethod") || config.check("homingMethods"))
+    {
+        if (!checkAndSet(axes, config, methods, "homingMethod", "homingMethods", "on-drive homing method (0: none)"))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        methods.assign(axes, 0.0);
+    }
+
+    homingMethods.assign(methods.begin(), methods.end());
+
+    if (config.check("homingZeroVel") || config.check("homingZeroVels"))
+    {
+        if (!checkAndSet(axes, config, homingZeroVels, "homingZeroVel", "homingZeroVels", "on-drive homing, speed during search for zero (degrees/second)"))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        homingZeroVels = homeSpecs.vel;
+    }
+
+    if (homingMethods.size() != static_cast<std::size_t>(axes) || homingZeroVels.size() != static_cast<std::size_t>(axes))
+    {
+        CD_ERROR("Size mismatch in on-drive homing parameters.\n");
+        return false;
+    }
+
+    homingTimeout = config.check("homingTimeout", yarp::os::Value(60.0), "on-drive homing timeout (seconds)").asFloat64();
+    return true;
 }
 
 bool JointCalibrator::close()
@@ -4,8 +4,11 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <numeric>
 
+#include <yarp/os/Vocab.h>
+
 #include <ColorDebug.h>
 
 using namespace roboticslab;
@@ -153,6 +156,78 @@ bool JointCalibrator::move(const std::vector<int> & joints, const MovementSpecs
     return ok;
 }
 
+bool JointCalibrator::home(const std::vector<int> & joints)
+{
+    std::vector<int> ids;
+
+    for (int joint : joints)
+    {
+        if (joint >= 0 && joint < axes && homingMethods[joint] != 0)
+        {
+            ids.push_back(joint);
+        }
+    }
+
+    if (!ids.empty())
+    {
+        if (!iControlCalibration)
+        {
+            CD_ERROR("On-drive homing requested, but calibration interface is not available.\n");
+            return false;
+        }
+
+        // start all sequences first, drives run them concurrently
+        for (int id : ids)
+        {
+            CD_INFO("Starting on-drive homing on joint %d (method: %d).\n", id, homingMethods[id]);
+
+            if (!iControlCalibration->calibrateAxisWithParams(id, homingMethods[id], homeSpecs.vel[id], homingZeroVels[id], homeSpecs.acc[id]))
+            {
+                CD_ERROR("Unable to start on-drive homing on joint %d.\n", id);
+                return false;
+            }
+        }
+
+        // completion is reported by the statusword, no bus traffic is involved here
+        double start = yarp::os::Time::now();
+
+        while (!ids.empty())
+        {
+            if (yarp::os::Time::now() - start > homingTimeout)
+            {
+                for (int id : ids)
+                {
+                    CD_ERROR("On-drive homing timed out on joint %d.\n", id);
+                }
+
+                return false;
+            }
+
+            yarp::os::Time::delay(MOTION_CHECK_INTERVAL);
+
+            for (int id : ids)
+            {
+                int mode;
+
+                // drives leave calibration mode on homing errors and faults, no need to wait for the timeout
+                if (iControlMode->getControlMode(id, &mode) && mode != VOCAB_CM_CALIBRATING)
+                {
+                    CD_ERROR("On-drive homing aborted on joint %d, current mode: %s.\n", id, yarp::os::Vocab::decode(mode).c_str());
+                    return false;
+                }
+            }
+
+            ids.erase(std::remove_if(ids.begin(), ids.end(), [this](int id)
+                { return iControlCalibration->calibrationDone(id); }),
+                ids.end());
+        }
+
+        CD_INFO("On-drive homing done.\n");
+    }
+
+    return move(joints, homeSpecs);
+}
+
 bool JointCalibrator::calibrateSingleJoint(int j)
 {
     CD_WARNING("Not supported.\n");
@@ -169,7 +244,7 @@ bool JointCalibrator::homingSingleJoint(int j)
 {
     CD_INFO("Performing homing procedure on joint %d.\n", j);
     std::vector<int> targets{j};
-    return move(targets, homeSpecs);
+    return home(targets);
 }
 
 bool JointCalibrator::homingWholePart()
@@ -177,7 +252,7 @@ bool JointCalibrator::homingWholePart()
     CD_INFO("Performing homing procedure on whole part.\n");
     std::vector<int> targets(axes);
     std::iota(targets.begin(), targets.end(), 0);
-    return move(targets, homeSpecs);
+    return home(targets);
 }
 
 bool JointCalibrator::parkSingleJoint(int j, bool wait)
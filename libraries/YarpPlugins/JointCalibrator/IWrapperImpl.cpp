@@ -8,6 +8,11 @@ bool JointCalibrator::attach(yarp::dev::PolyDriver * poly)
 {
     int localAxes;
 
+    if (!poly->view(iControlCalibration))
+    {
+        iControlCalibration = nullptr; // optional, only needed for on-drive homing
+    }
+
     return poly->view(iControlMode)
             && poly->view(iEncoders)
             && poly->view(iPositionControl)
@@ -7,6 +7,7 @@
 
 #include <yarp/dev/CalibratorInterfaces.h>
 #include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IControlCalibration.h>
 #include <yarp/dev/IControlMode.h>
 #include <yarp/dev/IEncoders.h>
 #include <yarp/dev/IPositionControl.h>
@@ -35,6 +36,9 @@ struct MovementSpecs
 /**
  * @ingroup JointCalibrator
  * @brief Remote calibrator class for multi-joint homing and park.
+ *
+ * Joints with a non-zero homing method are homed by their drives first, all
+ * of them at once, then every joint is moved to its home position.
  */
 class JointCalibrator : public yarp::dev::DeviceDriver,
                         public yarp::dev::IRemoteCalibrator,
@@ -42,7 +46,8 @@ class JointCalibrator : public yarp::dev::DeviceDriver,
 {
 public:
     JointCalibrator()
-        : axes(0), iControlMode(nullptr), iEncoders(nullptr), iPositionControl(nullptr)
+        : axes(0), homingTimeout(0.0),
+          iControlCalibration(nullptr), iControlMode(nullptr), iEncoders(nullptr), iPositionControl(nullptr)
     { }
 
     virtual bool calibrateSingleJoint(int j) override;
@@ -62,12 +67,18 @@ public:
 
 private:
     bool move(const std::vector<int> & joints, const MovementSpecs & specs);
+    bool home(const std::vector<int> & joints);
 
     int axes;
 
     MovementSpecs homeSpecs;
     MovementSpecs parkSpecs;
 
+    std::vector<int> homingMethods;
+    std::vector<double> homingZeroVels;
+    double homingTimeout;
+
+    yarp::dev::IControlCalibration * iControlCalibration;
     yarp::dev::IControlMode * iControlMode;
     yarp::dev::IEncoders * iEncoders;
     yarp::dev::IPositionControl * iPositionControl;
@@ -58,7 +58,14 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
     vars.pulsesPerSample = driverGroup.check("pulsesPerSample", yarp::os::Value(0), "pulsesPerSample").asInt32();
     vars.reverse = iposGroup.check("reverse", yarp::os::Value(false), "reverse motor encoder counts").asBool();
     vars.heartbeatPeriod = iposGroup.check("heartbeatPeriod", yarp::os::Value(0.0), "CAN heartbeat period (seconds)").asFloat64();
+
+    if (iposGroup.check("monitorPeriod", "deprecated, forwarded to the CAN bus group by CanBusControlboard")
+        && iposGroup.find("monitorPeriod").asFloat64() <= 0.0)
+    {
+        vars.heartbeatPeriod = 0.0; // legacy behavior, disable
+    }
     vars.syncPeriod = iposGroup.check("syncPeriod", yarp::os::Value(0.0), "SYNC message period (seconds)").asFloat64();
+    vars.nmtBroadcast = iposGroup.check("nmtBroadcast", yarp::os::Value(false), "NMT start/reset issued by the bus master").asBool();
     vars.initialMode = iposGroup.check("initialMode", yarp::os::Value(VOCAB_CM_IDLE), "initial YARP control mode vocab").asVocab();
 
     if (!vars.validateInitialState())
@@ -109,10 +116,51 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
 
     can = new CanOpenNode(vars.canId, sdoTimeout, driveStateTimeout);
 
+    if (iposGroup.check("sdoChannels", "additional SDO channels, list of (rx tx) base COB-IDs"))
+    {
+        const yarp::os::Bottle * sdoChannels = iposGroup.find("sdoChannels").asList();
+
+        for (int i = 0; sdoChannels && i < sdoChannels->size(); i++)
+        {
+            const yarp::os::Bottle * cobIds = sdoChannels->get(i).asList();
+
+            if (!cobIds || cobIds->size() != 2)
+            {
+                CD_ERROR("Illegal SDO channel COB-IDs, expected (rx tx) pair.\n");
+                return false;
+            }
+
+            can->addSdoChannel(cobIds->get(0).asInt32(), cobIds->get(1).asInt32());
+        }
+    }
+
+    bool sdoAdaptiveTimeout = iposGroup.check("sdoAdaptiveTimeout", yarp::os::Value(false),
+            "adapt CAN SDO timeout to measured round-trip times").asBool();
+    double sdoMinTimeout = iposGroup.check("sdoMinTimeout", yarp::os::Value(DEFAULT_SDO_MIN_TIMEOUT),
+            "CAN SDO adaptive timeout lower bound (seconds)").asFloat64();
+    double sdoMaxTimeout = iposGroup.check("sdoMaxTimeout", yarp::os::Value(DEFAULT_SDO_MAX_TIMEOUT),
+            "CAN SDO adaptive timeout upper bound (seconds)").asFloat64();
+    int sdoRetries = iposGroup.check("sdoRetries", yarp::os::Value(0), "CAN SDO request retransmissions on timeout").asInt32();
+
+    if (sdoRetries < 0)
+    {
+        CD_ERROR("Illegal CAN SDO retransmissions: %d.\n", sdoRetries);
+        return false;
+    }
+
+    for (auto * sdo : can->sdoPool()->getChannels())
+    {
+        if (sdoAdaptiveTimeout)
+        {
+            sdo->configureAdaptiveTimeout(sdoMinTimeout, sdoMaxTimeout);
+        }
+
+        sdo->configureRetries(sdoRetries);
+    }
+
     PdoConfiguration tpdo1Conf;
 
-    // Manufacturer Status Register (1002h) and Modes of Operation Display (6061h)
-    tpdo1Conf.addMapping<std::uint32_t>(0x1002).addMapping<std::int8_t>(0x6061);
+    tpdo1Conf.addMappings<ipos::Tpdo1Mapping>();
 
     if (iposGroup.check("tpdo1InhibitTime", "TPDO1 inhibit time (seconds)"))
     {
@@ -126,8 +174,7 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
 
     PdoConfiguration tpdo2Conf;
 
-    // Motion Error Register (2000h) and Detailed Error Register (2002h)
-    tpdo2Conf.addMapping<std::uint16_t>(0x2000).addMapping<std::uint16_t>(0x2002);
+    tpdo2Conf.addMappings<ipos::Tpdo2Mapping>();
 
     if (iposGroup.check("tpdo2InhibitTime", "TPDO2 inhibit time (seconds)"))
     {
@@ -141,58 +188,110 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
 
     PdoConfiguration tpdo3Conf;
 
-    // Position actual internal value (6063h) and Torque actual value (6077h)
-    tpdo3Conf.addMapping<std::int32_t>(0x6063).addMapping<std::int16_t>(0x6077);
+    tpdo3Conf.addMappings<ipos::Tpdo3Mapping>();
 
     tpdo3Conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC);
 
-    vars.tpdo1Conf = tpdo1Conf;
-    vars.tpdo2Conf = tpdo2Conf;
-    vars.tpdo3Conf = tpdo3Conf;
-
-    using namespace std::placeholders;
+    if (iposGroup.check("tpdo3SyncStartValue", "TPDO3 SYNC start value (requires SYNC counter)"))
+    {
+        tpdo3Conf.setSyncStartValue(iposGroup.find("tpdo3SyncStartValue").asInt32());
+    }
 
-    can->tpdo1()->registerHandler<std::uint16_t, std::uint16_t, std::int8_t>(std::bind(&TechnosoftIpos::handleTpdo1, this, _1, _2, _3));
-    can->tpdo2()->registerHandler<std::uint16_t, std::uint16_t>(std::bind(&TechnosoftIpos::handleTpdo2, this, _1, _2));
-    can->tpdo3()->registerHandler<std::int32_t, std::int16_t>(std::bind(&TechnosoftIpos::handleTpdo3, this, _1, _2));
+    vars.pdoProfiles = iposGroup.check("pdoProfiles", yarp::os::Value(false),
+            "remap TPDO3 per control mode (no current readings in position direct mode)").asBool();
 
-    can->emcy()->registerHandler(std::bind(&TechnosoftIpos::handleEmcy, this, _1, _2, _3));
-    can->emcy()->setErrorCodeRegistry<TechnosoftIposEmcy>();
+    vars.nativeCyclic = iposGroup.check("nativeCyclicModes", yarp::os::Value(false),
+            "cyclic synchronous velocity (CSV) and torque (CST) modes, with actual velocity on TPDO3").asBool();
 
-    can->nmt()->registerHandler(std::bind(&TechnosoftIpos::handleNmt, this, _1));
+    vars.positionRpdo = iposGroup.check("positionRpdo", yarp::os::Value(false),
+            "send profile position setpoints along with the controlword through RPDO2").asBool();
 
-    if (iposGroup.check("monitorPeriod", "monitor thread period (seconds)"))
+    if (iposGroup.check("coordinatedStart", yarp::os::Value(false), "release profile position setpoints on SYNC along with other joints").asBool())
     {
-        double monitorPeriod = iposGroup.find("monitorPeriod").asFloat64();
+        if (!vars.positionRpdo)
+        {
+            CD_ERROR("Coordinated start requires \"positionRpdo\" (canId: %d).\n", vars.canId);
+            return false;
+        }
 
-        if (monitorPeriod > 0.0)
+        if (!config.check("startSkewMeter") || !config.find("startSkewMeter").isBlob())
         {
-            monitorThread = new yarp::os::Timer(yarp::os::TimerSettings(monitorPeriod), std::bind(&TechnosoftIpos::monitorWorker, this, _1), true);
+            CD_ERROR("Missing \"startSkewMeter\" property or not a blob (canId: %d).\n", vars.canId);
+            return false;
         }
-        else
+
+        startSkewMeter = *reinterpret_cast<StartSkewMeter * const *>(config.find("startSkewMeter").asBlob());
+        startSkewMeter->enroll(vars.canId);
+        vars.coordinatedStart = true;
+    }
+
+    vars.fastModeSwitch = iposGroup.check("fastModeSwitch", yarp::os::Value(false),
+            "request modes of operation through RPDO4 (or MPDO), configure static mode parameters once").asBool();
+
+    vars.driveTimestamps = iposGroup.check("driveTimestamps", yarp::os::Value(false), "map high resolution time stamp on TPDO4").asBool();
+
+    if (vars.driveTimestamps)
+    {
+        // sampled on each SYNC
+        vars.tpdo4Conf.addMappings<ipos::Tpdo4Mapping>().setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC);
+    }
+
+    if (iposGroup.check("mpdoSetpoints", yarp::os::Value(false), "receive synchronous setpoints through DAM-MPDOs on RPDO4").asBool())
+    {
+        if (!config.check("mpdoProducer") || !config.find("mpdoProducer").isBlob())
         {
-            vars.heartbeatPeriod = 0.0; // disable
+            CD_ERROR("Missing \"mpdoProducer\" property or not a blob (canId: %d).\n", vars.canId);
+            return false;
         }
+
+        mpdoProducer = *reinterpret_cast<MpdoProducer * const *>(config.find("mpdoProducer").asBlob());
+        mpdoProducer->addNode(vars.canId);
+        can->rpdo4()->setCobId(mpdoProducer->getCobId());
     }
 
-    return !monitorThread || monitorThread->start();
-}
+    // lower values win bus arbitration if the bus master reassigns COB-IDs by priority, negative keeps default COB-ID
+    vars.rpdo3Priority = iposGroup.check("rpdo3Priority", yarp::os::Value(vars.rpdo3Priority), "RPDO3 (setpoints) priority class").asInt32();
+    vars.tpdo1Priority = iposGroup.check("tpdo1Priority", yarp::os::Value(vars.tpdo1Priority), "TPDO1 (status) priority class").asInt32();
+    vars.tpdo2Priority = iposGroup.check("tpdo2Priority", yarp::os::Value(vars.tpdo2Priority), "TPDO2 (errors) priority class").asInt32();
+    vars.tpdo3Priority = iposGroup.check("tpdo3Priority", yarp::os::Value(vars.tpdo3Priority), "TPDO3 (feedback) priority class").asInt32();
+    vars.tpdo4Priority = iposGroup.check("tpdo4Priority", yarp::os::Value(vars.tpdo4Priority), "TPDO4 (timestamps) priority class").asInt32();
 
-// -----------------------------------------------------------------------------
+    if (vars.positionRpdo)
+    {
+        // controlword goes last, see writePositionSetpoint(); synchronous RPDOs are applied on the next SYNC
+        vars.rpdo2Conf.addMapping<std::int32_t>(0x607A).addMapping<std::uint16_t>(0x6040)
+                .setTransmissionType(vars.coordinatedStart ? PdoTransmissionType::SYNCHRONOUS_ACYCLIC
+                                                           : PdoTransmissionType::EVENT_DRIVEN_DEVICE_APP_PROFILE);
+    }
 
-bool TechnosoftIpos::close()
-{
-    // we need to do this in finalize(), too, since the monitor thread could be
-    // still requesting CAN transfers even after CAN RX/TX threads have been
-    // closed in CanBusControlboard::close()
-    if (monitorThread && monitorThread->isRunning())
+    vars.tpdo1Conf = tpdo1Conf;
+    vars.tpdo2Conf = tpdo2Conf;
+    vars.tpdo3Conf = tpdo3Conf;
+
+    using namespace std::placeholders;
+
+    // the low and high words of the Manufacturer Status Register are the statusword and the MSR
+    can->tpdo1()->bindHandler<ipos::Tpdo1Mapping, decltype(&TechnosoftIpos::handleTpdo1), &TechnosoftIpos::handleTpdo1>(this);
+    can->tpdo2()->bindHandler<ipos::Tpdo2Mapping, decltype(&TechnosoftIpos::handleTpdo2), &TechnosoftIpos::handleTpdo2>(this);
+    can->tpdo3()->bindHandler<ipos::Tpdo3Mapping, decltype(&TechnosoftIpos::handleTpdo3), &TechnosoftIpos::handleTpdo3>(this);
+
+    if (vars.driveTimestamps)
     {
-        monitorThread->stop();
+        can->tpdo4()->bindHandler<ipos::Tpdo4Mapping, decltype(&TechnosoftIpos::handleTpdo4), &TechnosoftIpos::handleTpdo4>(this);
     }
 
-    delete monitorThread;
-    monitorThread = nullptr;
+    can->emcy()->registerHandler(std::bind(&TechnosoftIpos::handleEmcy, this, _1, _2, _3));
+    can->emcy()->setErrorCodeRegistry<TechnosoftIposEmcy>();
 
+    can->nmt()->registerHandler(std::bind(&TechnosoftIpos::handleNmt, this, _1));
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::close()
+{
     delete linInterpBuffer;
     linInterpBuffer = nullptr;
 
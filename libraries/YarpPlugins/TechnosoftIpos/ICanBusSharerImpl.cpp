@@ -5,8 +5,8 @@
 #include <cctype> // std::isspace
 
 #include <algorithm> // std::find_if
+#include <initializer_list>
 
-#include <yarp/os/Time.h>
 #include <yarp/os/Vocab.h>
 
 #include <ColorDebug.h>
@@ -55,6 +55,105 @@ std::vector<unsigned int> TechnosoftIpos::getAdditionalIds()
 
 // -----------------------------------------------------------------------------
 
+bool TechnosoftIpos::isCanOpenNode()
+{
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+DriveStatusMachine * TechnosoftIpos::getDriveStatus()
+{
+    return can->driveStatus();
+}
+
+// -----------------------------------------------------------------------------
+
+std::vector<unsigned int> TechnosoftIpos::getSyncPdoIds()
+{
+    if (vars.driveTimestamps && vars.tpdo4Conf.getFramesPerSync(vars.syncPeriod) == 1.0)
+    {
+        return {can->tpdo3()->getCobId(), can->tpdo4()->getCobId()};
+    }
+
+    return {can->tpdo3()->getCobId()};
+}
+
+// -----------------------------------------------------------------------------
+
+std::vector<CyclicFrame> TechnosoftIpos::getCyclicFrames()
+{
+    // statusword handshakes (TPDO1) and fault registers (TPDO2) must stay event-driven, only drive timestamps can be relaxed
+    std::vector<CyclicFrame> frames {
+        {can->tpdo1()->getCobId(), vars.tpdo1Conf.getMappedSize(), vars.tpdo1Conf.getFramesPerSync(vars.syncPeriod), false, vars.tpdo1Priority},
+        {can->tpdo2()->getCobId(), vars.tpdo2Conf.getMappedSize(), vars.tpdo2Conf.getFramesPerSync(vars.syncPeriod), false, vars.tpdo2Priority},
+        {can->tpdo3()->getCobId(), vars.tpdo3Conf.getMappedSize(), vars.tpdo3Conf.getFramesPerSync(vars.syncPeriod), false, vars.tpdo3Priority}
+    };
+
+    if (mpdoProducer)
+    {
+        // streamed command, see synchronize(); one DAM-MPDO per node unless all of them share the same value
+        frames.push_back({mpdoProducer->getCobId(), 8u, 1.0, false, -1});
+    }
+    else
+    {
+        // streamed command, see synchronize(); legacy PT/PVT points take a full frame (one on average, two at most)
+        frames.push_back({can->rpdo3()->getCobId(), linInterpBuffer ? 8u : 4u, 1.0, false, vars.rpdo3Priority});
+    }
+
+    if (vars.positionRpdo)
+    {
+        // profile position set-points along with the controlword, one per cycle at most is assumed
+        frames.push_back({can->rpdo2()->getCobId(), vars.rpdo2Conf.getMappedSize(), 1.0, false, -1});
+    }
+
+    if (vars.driveTimestamps)
+    {
+        frames.push_back({can->tpdo4()->getCobId(), vars.tpdo4Conf.getMappedSize(), vars.tpdo4Conf.getFramesPerSync(vars.syncPeriod),
+                vars.tpdo4Conf.isSynchronousCyclic(), vars.tpdo4Priority});
+    }
+
+    if (vars.heartbeatPeriod != 0.0)
+    {
+        frames.push_back({0x700u + can->getId(), 1, vars.syncPeriod / vars.heartbeatPeriod, false, -1});
+    }
+
+    return frames;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::setCyclicDivisor(unsigned int cobId, unsigned int divisor)
+{
+    // only frames already sent on SYNC, turning event-driven ones into cyclic would delay faults and handshakes
+    if (!vars.driveTimestamps || cobId != can->tpdo4()->getCobId() || !vars.tpdo4Conf.isSynchronousCyclic()
+        || divisor == 0 || divisor > 240)
+    {
+        return false;
+    }
+
+    vars.tpdo4Conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC_N(divisor));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::remapCobId(unsigned int cobId, unsigned int newCobId)
+{
+    for (auto * pdo : std::initializer_list<PdoProtocol *>{can->rpdo3(), can->tpdo1(), can->tpdo2(), can->tpdo3(), can->tpdo4()})
+    {
+        if (pdo->getCobId() == cobId)
+        {
+            pdo->setCobId(newCobId);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::registerSender(CanSenderDelegate * sender)
 {
     can->configureSender(sender);
@@ -65,34 +164,32 @@ bool TechnosoftIpos::registerSender(CanSenderDelegate * sender)
 
 bool TechnosoftIpos::initialize()
 {
-    if (!can->sdo()->ping())
+    if (!can->sdo()->ping() || !can->configureSdoChannels())
     {
         return false;
     }
 
+    // the node may have been reset since, RPDO3 is mapped on mode change
+    can->rpdo3()->resetMappingCache();
+
     if (!vars.configuredOnce)
     {
         // retrieve static drive info
-        vars.configuredOnce = can->sdo()->upload<std::uint32_t>("Device type",
+        vars.configuredOnce = can->sdo()->upload(ipos::DEVICE_TYPE,
                 [](auto data)
-                { CD_INFO("CiA standard: %d.\n", data & 0xFFFF); },
-                0x1000)
-            && can->sdo()->upload<std::uint32_t>("Supported drive modes",
+                { CD_INFO("CiA standard: %d.\n", data & 0xFFFF); })
+            && can->sdo()->upload(ipos::SUPPORTED_DRIVE_MODES,
                 [this](auto data)
-                { interpretSupportedDriveModes(data); },
-                0x6502)
-            && can->sdo()->upload("Manufacturer software version",
+                { interpretSupportedDriveModes(data); })
+            && can->sdo()->upload(ipos::MANUFACTURER_SOFTWARE_VERSION,
                 [](const auto & data)
-                { CD_INFO("Firmware version: %s.\n", rtrim(data).c_str()); },
-                0x100A)
-            && can->sdo()->upload<std::uint32_t>("Identity Object: Product Code",
+                { CD_INFO("Firmware version: %s.\n", rtrim(data).c_str()); })
+            && can->sdo()->upload(ipos::PRODUCT_CODE,
                 [](auto data)
-                { CD_INFO("Product code: P%03d.%03d.E%03d.\n", data / 1000000, (data / 1000) % 1000, data % 1000); },
-                0x1018, 0x02)
-            && can->sdo()->upload<std::uint32_t>("Identity Object: Serial number",
+                { CD_INFO("Product code: P%03d.%03d.E%03d.\n", data / 1000000, (data / 1000) % 1000, data % 1000); })
+            && can->sdo()->upload(ipos::SERIAL_NUMBER,
                 [](auto data)
-                { CD_INFO("Serial number: %c%c%02x%02x.\n", getByte(data, 3), getByte(data, 2), getByte(data, 1), getByte(data, 0)); },
-                0x1018, 0x04);
+                { CD_INFO("Serial number: %c%c%02x%02x.\n", getByte(data, 3), getByte(data, 2), getByte(data, 1), getByte(data, 0)); });
     }
 
     double extEnc;
@@ -107,18 +204,39 @@ bool TechnosoftIpos::initialize()
         || !can->tpdo1()->configure(vars.tpdo1Conf)
         || !can->tpdo2()->configure(vars.tpdo2Conf)
         || !can->tpdo3()->configure(vars.tpdo3Conf)
+        || !applyPdoProfile(VOCAB_CM_IDLE) // restore default handlers, no SDO transfers
+        || (vars.driveTimestamps && !can->tpdo4()->configure(vars.tpdo4Conf))
+        || (vars.positionRpdo && !can->rpdo2()->configure(vars.rpdo2Conf))
+        || (mpdoProducer && !can->rpdo4()->configure(PdoConfiguration().setMultiplexed(MpdoAddressing::DESTINATION)))
+        // modes of operation is either mapped on RPDO4 or sent as a DAM-MPDO, see requestModeOfOperation()
+        || (vars.fastModeSwitch && !mpdoProducer && !can->rpdo4()->configure(PdoConfiguration().addMapping<std::int8_t>(0x6060)
+                .setTransmissionType(PdoTransmissionType::EVENT_DRIVEN_DEVICE_APP_PROFILE)))
+        || (vars.fastModeSwitch && (!configureInterpolationPeriod() || !can->sdo()->download(ipos::EXTERNAL_REFERENCE_TYPE, 1)))
         || (vars.heartbeatPeriod != 0.0
-                && !can->sdo()->download<std::uint16_t>("Producer Heartbeat Time", vars.heartbeatPeriod * 1000, 0x1017))
-        || !can->nmt()->issueServiceCommand(NmtService::START_REMOTE_NODE)
-        || (can->driveStatus()->getCurrentState() == DriveState::NOT_READY_TO_SWITCH_ON
-                && !can->driveStatus()->awaitState(DriveState::SWITCH_ON_DISABLED)))
+                && !can->sdo()->download(ipos::PRODUCER_HEARTBEAT_TIME, vars.heartbeatPeriod * 1000))
+        || (!vars.nmtBroadcast && !can->nmt()->issueServiceCommand(NmtService::START_REMOTE_NODE)))
     {
         CD_ERROR("Initial SDO configuration and/or node start failed (canId: %d).\n", can->getId());
         return false;
     }
 
-    vars.lastHeartbeat = yarp::os::Time::now();
-    vars.actualControlMode = VOCAB_CM_CONFIGURED;
+    // in broadcast mode, start() is invoked once the bus master has started all nodes
+    return vars.nmtBroadcast || start();
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::start()
+{
+    if (can->driveStatus()->getCurrentState() == DriveState::NOT_READY_TO_SWITCH_ON
+            && !can->driveStatus()->awaitState(DriveState::SWITCH_ON_DISABLED))
+    {
+        CD_ERROR("Node start failed (canId: %d).\n", can->getId());
+        return false;
+    }
+
+    // the bus master may have already switched on this drive along with the others
+    vars.actualControlMode = can->driveStatus()->getCurrentState() == DriveState::SWITCHED_ON ? VOCAB_CM_IDLE : VOCAB_CM_CONFIGURED;
 
     if (!can->driveStatus()->requestState(DriveState::SWITCHED_ON)
             || !vars.awaitControlMode(VOCAB_CM_IDLE)
@@ -134,11 +252,6 @@ bool TechnosoftIpos::initialize()
 
 bool TechnosoftIpos::finalize()
 {
-    if (monitorThread && monitorThread->isRunning())
-    {
-        monitorThread->stop();
-    }
-
     bool ok = true;
 
     if (vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED)
@@ -157,7 +270,8 @@ bool TechnosoftIpos::finalize()
         vars.actualControlMode = VOCAB_CM_CONFIGURED;
     }
 
-    if (!can->nmt()->issueServiceCommand(NmtService::RESET_NODE))
+    // in broadcast mode, the bus master resets all nodes at once
+    if (!vars.nmtBroadcast && !can->nmt()->issueServiceCommand(NmtService::RESET_NODE))
     {
         CD_WARNING("Reset node NMT service failed.\n");
         ok = false;
@@ -174,6 +288,37 @@ bool TechnosoftIpos::finalize()
 
 // -----------------------------------------------------------------------------
 
+void TechnosoftIpos::notifyHeartbeatLost()
+{
+    if (vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED)
+    {
+        vars.actualControlMode = VOCAB_CM_NOT_CONFIGURED;
+        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
+        can->driveStatus()->reset();
+        vars.reset();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void TechnosoftIpos::notifyBootUp()
+{
+    if (vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED)
+    {
+        return;
+    }
+
+    // in broadcast mode, recover this node alone
+    if (!initialize()
+        || (vars.nmtBroadcast && (!can->nmt()->issueServiceCommand(NmtService::START_REMOTE_NODE) || !start())))
+    {
+        CD_ERROR("Unable to initialize CAN comms (canId: %d).\n", can->getId());
+        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::notifyMessage(const can_message & message)
 {
     if (iExternalEncoderCanBusSharer && iExternalEncoderCanBusSharer->getId() == (message.id & 0x7F))
@@ -201,13 +346,50 @@ bool TechnosoftIpos::synchronize()
 
     switch (vars.actualControlMode.load())
     {
+    case VOCAB_CM_POSITION:
+    {
+        if (!vars.startPending)
+        {
+            return true;
+        }
+
+        // halted after staging, releasing now would overwrite the halt bit with the RPDO2 controlword
+        if (can->driveStatus()->controlword()[8])
+        {
+            vars.startPending = false;
+            return true;
+        }
+
+        // registered before the staged flag is cleared, see checkMotionDoneRaw()
+        vars.setpointHandshake.registerSetpoint();
+        vars.startPending = false;
+
+        if (startSkewMeter)
+        {
+            startSkewMeter->release(can->getId());
+        }
+
+        return writePositionSetpoint(vars.stagedTarget, vars.stagedRelative);
+    }
     case VOCAB_CM_VELOCITY:
     {
-        if (vars.enableCsv)
+        if (vars.nativeCyclic)
+        {
+            // same fixed-point encoding as profile velocity mode, see below
+            double value = vars.degreesToInternalUnits(vars.synchronousCommandTarget, 1);
+
+            std::int16_t dataInt;
+            std::uint16_t dataFrac;
+            CanUtils::encodeFixedPoint(value, &dataInt, &dataFrac);
+
+            std::int32_t data = (dataInt << 16) + dataFrac;
+            return sendSyncTarget(0x60FF, data);
+        }
+        else if (vars.enableCsv)
         {
             double value = vars.synchronousCommandTarget * vars.syncPeriod;
             std::int32_t data = vars.degreesToInternalUnits(value);
-            return can->rpdo3()->write(data);
+            return sendSyncTarget(0x607A, data);
         }
         else
         {
@@ -218,32 +400,52 @@ bool TechnosoftIpos::synchronize()
             CanUtils::encodeFixedPoint(value, &dataInt, &dataFrac);
 
             std::int32_t data = (dataInt << 16) + dataFrac;
-            return can->rpdo3()->write(data);
+            return sendSyncTarget(0x60FF, data);
         }
     }
     case VOCAB_CM_TORQUE:
     {
         double curr = vars.torqueToCurrent(vars.synchronousCommandTarget);
+
+        if (vars.nativeCyclic)
+        {
+            // iPOS expresses target torque in current internal units
+            return sendSyncTarget(0x6071, vars.currentToInternalUnits(curr));
+        }
+
         std::int32_t data = vars.currentToInternalUnits(curr) << 16;
-        return can->rpdo3()->write(data);
+        return sendSyncTarget(0x201C, data);
     }
     case VOCAB_CM_CURRENT:
     {
+        if (vars.nativeCyclic)
+        {
+            return sendSyncTarget(0x6071, vars.currentToInternalUnits(vars.synchronousCommandTarget));
+        }
+
         std::int32_t data = vars.currentToInternalUnits(vars.synchronousCommandTarget) << 16;
-        return can->rpdo3()->write(data);
+        return sendSyncTarget(0x201C, data);
     }
     case VOCAB_CM_POSITION_DIRECT:
     {
         if (linInterpBuffer)
         {
-            std::uint64_t data = linInterpBuffer->makeDataRecord(vars.synchronousCommandTarget);
-            return can->rpdo3()->write(data);
+            // one record per SYNC, except while the target holds still
+            int records = linInterpBuffer->reserveRecords(vars.synchronousCommandTarget);
+            bool ok = true;
+
+            for (int i = 0; i < records; i++)
+            {
+                ok &= can->rpdo3()->write(linInterpBuffer->makeDataRecord(vars.synchronousCommandTarget));
+            }
+
+            return ok;
         }
         else
         {
             double value = vars.clipSyncPositionTarget();
             std::int32_t data = vars.degreesToInternalUnits(value);
-            return can->rpdo3()->write(data);
+            return sendSyncTarget(0x607A, data);
         }
     }
     default:
@@ -0,0 +1,86 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "TechnosoftIpos.hpp"
+
+#include <cmath>
+
+#include <ColorDebug.h>
+
+#include "CanUtils.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    std::uint32_t encodeHomingParameter(double value)
+    {
+        std::uint16_t dataInt;
+        std::uint16_t dataFrac;
+        CanUtils::encodeFixedPoint(std::abs(value), &dataInt, &dataFrac);
+        return (dataInt << 16) + dataFrac;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::calibrateAxisWithParamsRaw(int axis, unsigned int type, double p1, double p2, double p3)
+{
+    CD_DEBUG("(%d, %d, %f, %f, %f)\n", axis, type, p1, p2, p3);
+    CHECK_JOINT(axis);
+
+    // type: homing method (negative values wrap around), p1: speed during search for switch [deg/s],
+    // p2: speed during search for zero [deg/s], p3: homing acceleration [deg/s^2]
+    std::int8_t method = static_cast<std::int8_t>(type);
+
+    if (p1 > vars.maxVel || p2 > vars.maxVel)
+    {
+        CD_WARNING("Homing speed exceeds maximum velocity (%f).\n", vars.maxVel.load());
+        return false;
+    }
+
+    vars.enableSync = false;
+
+    // reset mode-specific bits (4-6) and halt bit (8)
+    if (!can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4).reset(5).reset(6).reset(8)))
+    {
+        return false;
+    }
+
+    // the drive runs the whole sequence on its own, progress is tracked via statusword (TPDO1)
+    return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
+        && can->sdo()->download(ipos::HOMING_METHOD, method)
+        && can->sdo()->download(ipos::HOMING_SPEED_SWITCH, encodeHomingParameter(vars.degreesToInternalUnits(p1, 1)))
+        && can->sdo()->download(ipos::HOMING_SPEED_ZERO, encodeHomingParameter(vars.degreesToInternalUnits(p2, 1)))
+        && can->sdo()->download(ipos::HOMING_ACCELERATION, encodeHomingParameter(vars.degreesToInternalUnits(p3, 2)))
+        && requestModeOfOperation(6)
+        && vars.awaitControlMode(VOCAB_CM_CALIBRATING)
+        && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4)); // start homing
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::setCalibrationParametersRaw(int axis, const yarp::dev::CalibrationParameters & params)
+{
+    CD_DEBUG("(%d)\n", axis);
+    return calibrateAxisWithParamsRaw(axis, params.type, params.param1, params.param2, params.param3);
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::calibrationDoneRaw(int j)
+{
+    //CD_DEBUG("(%d)\n", j); // too verbose while polling
+    CHECK_JOINT(j);
+
+    if (vars.actualControlMode != VOCAB_CM_CALIBRATING)
+    {
+        return false;
+    }
+
+    auto statusword = can->driveStatus()->statusword();
+
+    // homing errors are reported as VOCAB_CM_HW_FAULT by getControlModeRaw()
+    return statusword[12] && !statusword[13]; // homing attained
+}
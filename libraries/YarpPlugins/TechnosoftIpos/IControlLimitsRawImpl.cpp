@@ -35,22 +35,8 @@ bool TechnosoftIpos::setLimitsRaw(int axis, double min, double max)
 
 bool TechnosoftIpos::setLimitRaw(double limit, bool isMin)
 {
-    std::string name = "Software position limit: ";
-    std::uint8_t subindex;
-
-    if (isMin ^ vars.reverse)
-    {
-        name += "minimal position limit";
-        subindex = 0x01;
-    }
-    else
-    {
-        name += "maximal position limit";
-        subindex = 0x02;
-    }
-
-    std::int32_t data = vars.degreesToInternalUnits(limit);
-    return can->sdo()->download(name, data, 0x607D, subindex);
+    const auto & obj = (isMin ^ vars.reverse) ? ipos::MIN_POSITION_LIMIT : ipos::MAX_POSITION_LIMIT;
+    return can->sdo()->download(obj, vars.degreesToInternalUnits(limit));
 }
 
 // -----------------------------------------------------------------------------
@@ -74,23 +60,10 @@ bool TechnosoftIpos::getLimitsRaw(int axis, double * min, double * max)
 
 bool TechnosoftIpos::getLimitRaw(double * limit, bool isMin)
 {
-    std::string name = "Software position limit: ";
-    std::uint8_t subindex;
-
-    if (isMin ^ vars.reverse)
-    {
-        name += "minimal position limit";
-        subindex = 0x01;
-    }
-    else
-    {
-        name += "maximal position limit";
-        subindex = 0x02;
-    }
+    const auto & obj = (isMin ^ vars.reverse) ? ipos::MIN_POSITION_LIMIT : ipos::MAX_POSITION_LIMIT;
 
-    return can->sdo()->upload<std::int32_t>(name, [this, limit](auto data)
-        { *limit = vars.internalUnitsToDegrees(data); },
-        0x607D, subindex);
+    return can->sdoPool()->acquire()->upload(obj, [this, limit](auto data)
+        { *limit = vars.internalUnitsToDegrees(data); });
 }
 
 // -----------------------------------------------------------------------------
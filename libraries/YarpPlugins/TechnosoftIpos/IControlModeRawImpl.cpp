@@ -23,14 +23,14 @@ bool TechnosoftIpos::setLegacyPositionInterpolationMode()
     std::int32_t refInternalUnits = vars.lastEncoderRead.queryPosition();
 
     if (!can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-        || !can->rpdo3()->configure(rpdo3Conf)
-        || !can->sdo()->download<std::uint16_t>("Auxiliary Settings Register", 0x0000, 0x208E) // legacy pt mode
-        || !can->sdo()->download<std::int16_t>("Interpolation sub mode select", linInterpBuffer->getSubMode(), 0x60C0)
+        || !can->rpdo3()->remap(rpdo3Conf)
+        || !can->sdo()->download(ipos::AUXILIARY_SETTINGS_REGISTER, 0x0000) // legacy pt mode
+        || !can->sdo()->download(ipos::INTERPOLATION_SUB_MODE_SELECT, linInterpBuffer->getSubMode())
         // consume one additional slot to avoid annoying buffer full warnings
-        || !can->sdo()->download<std::uint16_t>("Interpolated position buffer length", linInterpBuffer->getBufferSize() + 1, 0x2073)
-        || !can->sdo()->download<std::uint16_t>("Interpolated position buffer configuration", 0xA080, 0x2074)
-        || !can->sdo()->download<std::int32_t>("Interpolated position initial position", refInternalUnits, 0x2079)
-        || !can->sdo()->download<std::int8_t>("Modes of Operation", 7, 0x6060)
+        || !can->sdo()->download(ipos::IP_BUFFER_LENGTH, linInterpBuffer->getBufferSize() + 1)
+        || !can->sdo()->download(ipos::IP_BUFFER_CONFIGURATION, 0xA080)
+        || !can->sdo()->download(ipos::IP_INITIAL_POSITION, refInternalUnits)
+        || !requestModeOfOperation(7)
         || !vars.awaitControlMode(VOCAB_CM_POSITION_DIRECT))
     {
         return false;
@@ -38,11 +38,14 @@ bool TechnosoftIpos::setLegacyPositionInterpolationMode()
 
     vars.synchronousCommandTarget = vars.internalUnitsToDegrees(refInternalUnits);
 
-    for (int i = 0; i < linInterpBuffer->getBufferSize(); i++)
+    // prefill up to the initial lead depth, further records are queued on each SYNC
+    int records = linInterpBuffer->reserveRecords(vars.synchronousCommandTarget);
+
+    for (int i = 0; i < records; i++)
     {
         if (!can->rpdo3()->write(linInterpBuffer->makeDataRecord(vars.synchronousCommandTarget)))
         {
-            CD_ERROR("Unable to send point %d/%d to buffer.\n", i + 1, linInterpBuffer->getBufferSize());
+            CD_ERROR("Unable to send point %d/%d to buffer.\n", i + 1, records);
             return false;
         }
     }
@@ -52,11 +55,93 @@ bool TechnosoftIpos::setLegacyPositionInterpolationMode()
 
 // -----------------------------------------------------------------------------
 
+bool TechnosoftIpos::configureInterpolationPeriod()
+{
+    return can->sdo()->download(ipos::INTERPOLATION_TIME_PERIOD_VALUE, vars.syncPeriod * 1000)
+        && can->sdo()->download(ipos::INTERPOLATION_TIME_PERIOD_INDEX, -3);
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::requestModeOfOperation(std::int8_t mode)
+{
+    if (!vars.fastModeSwitch)
+    {
+        return can->sdo()->download(ipos::MODES_OF_OPERATION, mode);
+    }
+
+    // single frame, no confirmation; the drive reports the new mode via TPDO1 (6061h)
+    return mpdoProducer ? mpdoProducer->write(can->getId(), 0x6060, 0x00, mode) : can->rpdo4()->write(mode);
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::applyPdoProfile(int mode)
+{
+    // native cyclic modes need actual velocity feedback regardless of PDO profiles
+    if (!vars.pdoProfiles && !vars.nativeCyclic)
+    {
+        return true;
+    }
+
+    // the handler is swapped once the drive has accepted the new layout, so that it keeps matching
+    // the last valid mapping on failure; stale frames are dropped on size mismatch, therefore velocity
+    // feedback is cleared only after the old handler can no longer be reached
+    switch (mode)
+    {
+    case VOCAB_CM_POSITION_DIRECT:
+        if (vars.pdoProfiles)
+        {
+            if (!can->tpdo3()->remap(PdoConfiguration().addMappings<ipos::Tpdo3PositionMapping>()))
+            {
+                return false;
+            }
+
+            can->tpdo3()->bindHandler<ipos::Tpdo3PositionMapping, decltype(&TechnosoftIpos::handleTpdo3Position), &TechnosoftIpos::handleTpdo3Position>(this);
+            vars.velocityFeedback = false;
+            return true;
+        }
+        break;
+    case VOCAB_CM_VELOCITY:
+        if (vars.nativeCyclic)
+        {
+            if (!can->tpdo3()->remap(PdoConfiguration().addMappings<ipos::Tpdo3VelocityMapping>()))
+            {
+                return false;
+            }
+
+            can->tpdo3()->bindHandler<ipos::Tpdo3VelocityMapping, decltype(&TechnosoftIpos::handleTpdo3Velocity), &TechnosoftIpos::handleTpdo3Velocity>(this);
+            vars.velocityFeedback = false;
+            return true;
+        }
+        break;
+    }
+
+    // CST mode reads actual torque from the default layout, too
+    if (!can->tpdo3()->remap(PdoConfiguration().addMappings<ipos::Tpdo3Mapping>()))
+    {
+        return false;
+    }
+
+    can->tpdo3()->bindHandler<ipos::Tpdo3Mapping, decltype(&TechnosoftIpos::handleTpdo3), &TechnosoftIpos::handleTpdo3>(this);
+    vars.velocityFeedback = false;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::getControlModeRaw(int j, int * mode)
 {
     //CD_DEBUG("(%d)\n", j); // too verbose in controlboardwrapper2 stream
     CHECK_JOINT(j);
     *mode = vars.actualControlMode;
+
+    // not a fault of the drive state machine, but the homing sequence has been aborted
+    if (*mode == VOCAB_CM_CALIBRATING && can->driveStatus()->statusword()[13])
+    {
+        *mode = VOCAB_CM_HW_FAULT;
+    }
+
     return true;
 }
 
@@ -93,6 +178,8 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     }
 
     vars.enableSync = false;
+    vars.setpointHandshake.reset();
+    vars.startPending = false;
 
     // reset mode-specific bits (4-6) and halt bit (8)
     if (!can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4).reset(5).reset(6).reset(8)))
@@ -100,8 +187,10 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
         return false;
     }
 
-    // bug in F508M/F509M firmware, switch to homing mode to stop controlling external reference torque
-    if (extRefTorque && !can->sdo()->download<std::int8_t>("Modes of Operation", 6, 0x6060))
+    // bug in F508M/F509M firmware, switch to homing mode to stop controlling external reference torque;
+    // unconfirmed PDO requests must take effect before the target mode is requested
+    if (extRefTorque && (!requestModeOfOperation(6)
+        || (vars.fastModeSwitch && !vars.awaitControlMode(VOCAB_CM_CALIBRATING))))
     {
         return false;
     }
@@ -110,29 +199,40 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     {
     case VOCAB_CM_POSITION:
         return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->sdo()->download<std::int32_t>("Target position", vars.lastEncoderRead.queryPosition(), 0x607A)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 1, 0x6060)
+            && applyPdoProfile(mode)
+            && can->sdo()->download(ipos::TARGET_POSITION, vars.lastEncoderRead.queryPosition())
+            && requestModeOfOperation(1)
             && can->driveStatus()->controlword(can->driveStatus()->controlword().set(5)) // change set immediately
             && vars.awaitControlMode(mode);
 
     case VOCAB_CM_VELOCITY:
         vars.synchronousCommandTarget = 0.0;
 
-        if (vars.enableCsv)
+        if (vars.nativeCyclic)
+        {
+            return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
+                && applyPdoProfile(mode)
+                && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int32_t>(0x60FF))
+                && (vars.fastModeSwitch || configureInterpolationPeriod())
+                && requestModeOfOperation(9)
+                && vars.awaitControlMode(mode);
+        }
+        else if (vars.enableCsv)
         {
             return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-                && can->rpdo3()->configure(PdoConfiguration().addMapping<std::int32_t>(0x607A))
-                && can->sdo()->download<std::uint8_t>("Interpolation time period", vars.syncPeriod * 1000, 0x60C2, 0x01)
-                && can->sdo()->download<std::int8_t>("Interpolation time period", -3, 0x60C2, 0x02)
-                && can->sdo()->download<std::int8_t>("Modes of Operation", 8, 0x6060)
+                && applyPdoProfile(mode)
+                && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int32_t>(0x607A))
+                && (vars.fastModeSwitch || configureInterpolationPeriod())
+                && requestModeOfOperation(8)
                 && can->driveStatus()->controlword(can->driveStatus()->controlword().set(6)) // relative position mode
                 && vars.awaitControlMode(mode);
         }
         else
         {
             return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-                && can->rpdo3()->configure(PdoConfiguration().addMapping<std::int32_t>(0x60FF))
-                && can->sdo()->download<std::int8_t>("Modes of Operation", 3, 0x6060)
+                && applyPdoProfile(mode)
+                && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int32_t>(0x60FF))
+                && requestModeOfOperation(3)
                 && vars.awaitControlMode(mode);
         }
 
@@ -140,23 +240,34 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     case VOCAB_CM_TORQUE:
         vars.synchronousCommandTarget = 0.0;
 
+        if (vars.nativeCyclic)
+        {
+            return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
+                && applyPdoProfile(mode)
+                && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int16_t>(0x6071))
+                && (vars.fastModeSwitch || configureInterpolationPeriod())
+                && requestModeOfOperation(10)
+                && vars.awaitControlMode(mode);
+        }
+
         return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->rpdo3()->configure(PdoConfiguration().addMapping<std::int32_t>(0x201C))
-            && can->sdo()->download<std::uint16_t>("External Reference Type", 1, 0x201D)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", -5, 0x6060)
+            && applyPdoProfile(mode)
+            && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int32_t>(0x201C))
+            && (vars.fastModeSwitch || can->sdo()->download(ipos::EXTERNAL_REFERENCE_TYPE, 1))
+            && requestModeOfOperation(-5)
             && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4)) // new setpoint (assume target position)
             && vars.awaitControlMode(mode);
 
     case VOCAB_CM_POSITION_DIRECT:
         if (linInterpBuffer)
         {
-            // TODO: https://github.com/roboticslab-uc3m/yarp-devices/issues/222#issuecomment-575092455
-            return false; //setLegacyPositionInterpolationMode();
+            // buffer occupancy is steered by InterpolationBufferModel, see synchronize()
+            return setLegacyPositionInterpolationMode();
         }
 
         // bug in F508M/F509M firmware, switch to homing mode to stop controlling profile velocity
-        if (vars.actualControlMode == VOCAB_CM_VELOCITY && !vars.enableCsv
-            && !can->sdo()->download<std::int8_t>("Modes of Operation", 6, 0x6060))
+        if (vars.actualControlMode == VOCAB_CM_VELOCITY && !vars.enableCsv && !vars.nativeCyclic
+            && (!requestModeOfOperation(6) || (vars.fastModeSwitch && !vars.awaitControlMode(VOCAB_CM_CALIBRATING))))
         {
             return false;
         }
@@ -165,10 +276,10 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
         vars.prevSyncTarget.store(vars.synchronousCommandTarget);
 
         return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->rpdo3()->configure(PdoConfiguration().addMapping<std::int32_t>(0x607A))
-            && can->sdo()->download<std::uint8_t>("Interpolation time period", vars.syncPeriod * 1000, 0x60C2, 0x01)
-            && can->sdo()->download<std::int8_t>("Interpolation time period", -3, 0x60C2, 0x02)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 8, 0x6060)
+            && applyPdoProfile(mode)
+            && can->rpdo3()->remap(PdoConfiguration().addMapping<std::int32_t>(0x607A))
+            && (vars.fastModeSwitch || configureInterpolationPeriod())
+            && requestModeOfOperation(8)
             && vars.awaitControlMode(mode);
 
     case VOCAB_CM_FORCE_IDLE:
@@ -183,7 +294,8 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
 
     case VOCAB_CM_IDLE:
         return can->driveStatus()->requestState(DriveState::SWITCHED_ON)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 0, 0x6060); // reset drive mode
+            && applyPdoProfile(mode)
+            && requestModeOfOperation(0); // reset drive mode
 
     default:
         CD_ERROR("Unsupported, unknown or read-only mode: %s.\n", yarp::os::Vocab::decode(mode).c_str());
@@ -32,10 +32,9 @@ bool TechnosoftIpos::getCurrentRangeRaw(int m, double * min, double * max)
     CD_DEBUG("(%d)\n", m);
     CHECK_JOINT(m);
 
-    return can->sdo()->upload<std::uint16_t>("Current limit", [this, min, max](auto data)
+    return can->sdoPool()->acquire()->upload(ipos::CURRENT_LIMIT, [this, min, max](auto data)
         { *max = vars.internalUnitsToPeakCurrent(data);
-          *min = -(*max); },
-        0x207F);
+          *min = -(*max); });
 }
 
 // -----------------------------------------------------------------------------
@@ -39,7 +39,7 @@ bool TechnosoftIpos::setEncoderRaw(int j, double val)
     CHECK_JOINT(j);
     std::int32_t data = vars.degreesToInternalUnits(val);
 
-    if (!can->sdo()->download("Set actual position", data, 0X2081))
+    if (!can->sdo()->download(ipos::SET_ACTUAL_POSITION, data))
     {
         return false;
     }
@@ -81,6 +81,13 @@ bool TechnosoftIpos::getEncoderSpeedRaw(int j, double * sp)
 {
     //CD_DEBUG("(%d)\n", j); // too verbose in controlboardwrapper2 stream
     CHECK_JOINT(j);
+
+    if (vars.velocityFeedback && vars.actualControlMode == VOCAB_CM_VELOCITY)
+    {
+        *sp = vars.lastVelocityRead; // reported by the drive in CSV mode
+        return true;
+    }
+
     double temp = vars.lastEncoderRead.querySpeed();
     *sp = vars.internalUnitsToDegrees(temp, 1);
     return true;
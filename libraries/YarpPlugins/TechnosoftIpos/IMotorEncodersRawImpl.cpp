@@ -58,7 +58,7 @@ bool TechnosoftIpos::setMotorEncoderRaw(int m, double val)
     CHECK_JOINT(m);
     std::int32_t data = vars.reverse ? -val : val;
 
-    if (!can->sdo()->download("Set actual position", data, 0X2081))
+    if (!can->sdo()->download(ipos::SET_ACTUAL_POSITION, data))
     {
         return false;
     }
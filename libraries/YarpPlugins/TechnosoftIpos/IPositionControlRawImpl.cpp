@@ -12,16 +12,56 @@ using namespace roboticslab;
 
 // --------------------------------------------------------------------------------
 
+bool TechnosoftIpos::sendPositionSetpoint(std::int32_t target, bool relative)
+{
+    if (can->driveStatus()->controlword()[8]) // check halt bit
+    {
+        return false;
+    }
+
+    if (vars.coordinatedStart)
+    {
+        // released on SYNC along with other joints, see synchronize()
+        vars.stagedTarget = target;
+        vars.stagedRelative = relative;
+        vars.startPending = true;
+        return true;
+    }
+
+    if (!vars.positionRpdo)
+    {
+        return can->sdo()->download(ipos::TARGET_POSITION, target)
+            // new setpoint (absolute or relative target position)
+            && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4).set(6, relative));
+    }
+
+    vars.setpointHandshake.registerSetpoint(); // before sending, the acknowledgement may arrive right away
+    return writePositionSetpoint(target, relative);
+}
+
+// --------------------------------------------------------------------------------
+
+bool TechnosoftIpos::writePositionSetpoint(std::int32_t target, bool relative)
+{
+    // previous set-point not acknowledged yet, force a rising edge on bit 4
+    if (can->driveStatus()->controlword()[4]
+        && !can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4)))
+    {
+        return false;
+    }
+
+    // single frame, no round trip; the drive acknowledges the set-point via statusword (TPDO1)
+    return can->driveStatus()->controlword(can->rpdo2(), can->driveStatus()->controlword().set(4).set(6, relative), target);
+}
+
+// --------------------------------------------------------------------------------
+
 bool TechnosoftIpos::positionMoveRaw(int j, double ref)
 {
     CD_DEBUG("(%d, %f)\n", j, ref);
     CHECK_JOINT(j);
     CHECK_MODE(VOCAB_CM_POSITION);
-
-    return !can->driveStatus()->controlword()[8] // check halt bit
-        && can->sdo()->download<std::int32_t>("Target position", vars.degreesToInternalUnits(ref), 0x607A)
-        // new setpoint (assume absolute target position)
-        && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4).reset(6));
+    return sendPositionSetpoint(vars.degreesToInternalUnits(ref), false);
 }
 
 // --------------------------------------------------------------------------------
@@ -47,11 +87,7 @@ bool TechnosoftIpos::relativeMoveRaw(int j, double delta)
     CD_DEBUG("(%d, %f)\n", j, delta);
     CHECK_JOINT(j);
     CHECK_MODE(VOCAB_CM_POSITION);
-
-    return !can->driveStatus()->controlword()[8] // check halt bit
-        && can->sdo()->download<std::int32_t>("Target position", vars.degreesToInternalUnits(delta), 0x607A)
-        // new setpoint (assume relative target position)
-        && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4).set(6));
+    return sendPositionSetpoint(vars.degreesToInternalUnits(delta), true);
 }
 
 // --------------------------------------------------------------------------------
@@ -76,7 +112,9 @@ bool TechnosoftIpos::checkMotionDoneRaw(int j, bool * flag)
 {
     //CD_DEBUG("(%d)\n", j);
     CHECK_JOINT(j);
-    *flag = can->driveStatus()->getCurrentState() != DriveState::OPERATION_ENABLED || can->driveStatus()->statusword()[10];
+    // target reached bit may be stale until the drive acknowledges the last set-point sent via PDO
+    *flag = can->driveStatus()->getCurrentState() != DriveState::OPERATION_ENABLED
+        || (can->driveStatus()->statusword()[10] && !vars.startPending && !vars.setpointHandshake.isPending());
     return true;
 }
 
@@ -122,7 +160,7 @@ bool TechnosoftIpos::setRefSpeedRaw(int j, double sp)
 
     std::uint32_t data = (dataInt << 16) + dataFrac;
 
-    if (!can->sdo()->download("Profile velocity", data, 0x6081))
+    if (!can->sdo()->download(ipos::PROFILE_VELOCITY, data))
     {
         return false;
     }
@@ -168,7 +206,7 @@ bool TechnosoftIpos::setRefAccelerationRaw(int j, double acc)
 
     std::uint32_t data = (dataInt << 16) + dataFrac;
 
-    if (!can->sdo()->download("Profile acceleration", data, 0x6083))
+    if (!can->sdo()->download(ipos::PROFILE_ACCELERATION, data))
     {
         return false;
     }
@@ -206,14 +244,13 @@ bool TechnosoftIpos::getRefSpeedRaw(int j, double * ref)
         return true;
     }
 
-    return can->sdo()->upload<std::uint32_t>("Profile velocity", [this, ref](auto data)
+    return can->sdoPool()->acquire()->upload(ipos::PROFILE_VELOCITY, [this, ref](auto data)
         {
             std::uint16_t dataInt = data >> 16;
             std::uint16_t dataFrac = data & 0xFFFF;
             double value = CanUtils::decodeFixedPoint(dataInt, dataFrac);
             *ref = std::abs(vars.internalUnitsToDegrees(value, 1));
-        },
-        0x6081);
+        });
 }
 
 // --------------------------------------------------------------------------------
@@ -245,14 +282,13 @@ bool TechnosoftIpos::getRefAccelerationRaw(int j, double * acc)
         return true;
     }
 
-    return can->sdo()->upload<std::uint32_t>("Profile acceleration", [this, acc](auto data)
+    return can->sdoPool()->acquire()->upload(ipos::PROFILE_ACCELERATION, [this, acc](auto data)
         {
             std::uint16_t dataInt = data >> 16;
             std::uint16_t dataFrac = data & 0xFFFF;
             double value = CanUtils::decodeFixedPoint(dataInt, dataFrac);
             *acc = std::abs(vars.internalUnitsToDegrees(value, 2));
-        },
-        0x6083);
+        });
 }
 
 // --------------------------------------------------------------------------------
@@ -306,9 +342,8 @@ bool TechnosoftIpos::getTargetPositionRaw(int joint, double * ref)
     CD_DEBUG("\n");
     CHECK_JOINT(joint);
 
-    return can->sdo()->upload<std::int32_t>("Target position", [this, ref](auto data)
-        { *ref = vars.internalUnitsToDegrees(data); },
-        0x607A);
+    return can->sdoPool()->acquire()->upload(ipos::TARGET_POSITION, [this, ref](auto data)
+        { *ref = vars.internalUnitsToDegrees(data); });
 }
 
 // --------------------------------------------------------------------------------
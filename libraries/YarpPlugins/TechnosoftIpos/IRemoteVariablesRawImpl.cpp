@@ -31,6 +31,12 @@ bool TechnosoftIpos::getRemoteVariableRaw(std::string key, yarp::os::Bottle & va
         dict.put("periodMs", linInterpBuffer->getPeriodMs());
         dict.put("bufferSize", linInterpBuffer->getBufferSize());
         dict.put("mode", linInterpBuffer->getType());
+        dict.put("targetLatencyMs", linInterpBuffer->getTargetLatencyMs());
+        dict.put("leadDepth", linInterpBuffer->getLeadDepth());
+        dict.put("occupancy", linInterpBuffer->getOccupancy());
+        dict.put("latencyMs", linInterpBuffer->getLatencyMs());
+        dict.put("underflows", static_cast<int>(linInterpBuffer->getUnderflows()));
+        dict.put("icErrors", static_cast<int>(linInterpBuffer->getIntegrityErrors()));
         return true;
     }
     else if (key == "csv")
@@ -40,6 +46,33 @@ bool TechnosoftIpos::getRemoteVariableRaw(std::string key, yarp::os::Bottle & va
         list.addInt8(vars.enableCsv);
         return true;
     }
+    else if (key == "sdo")
+    {
+        SdoMetrics metrics = can->sdo()->getMetrics();
+        yarp::os::Property & dict = val.addDict();
+        dict.put("srtt", metrics.srtt);
+        dict.put("rttvar", metrics.rttvar);
+        dict.put("timeout", metrics.timeout);
+        dict.put("transfers", static_cast<int>(metrics.transfers));
+        dict.put("timeouts", static_cast<int>(metrics.timeouts));
+        dict.put("retries", static_cast<int>(metrics.retries));
+        return true;
+    }
+    else if (key == "clock")
+    {
+        yarp::os::Property & dict = val.addDict();
+        dict.put("enable", vars.driveTimestamps);
+
+        if (vars.driveTimestamps)
+        {
+            dict.put("offset", vars.driveClock.getOffset());
+            dict.put("drift", vars.driveClock.getDrift());
+            dict.put("error", vars.driveClock.getError());
+            dict.put("samples", static_cast<int>(vars.driveClock.getSamples()));
+        }
+
+        return true;
+    }
 
     CD_ERROR("Unsupported key: \"%s\".\n", key.c_str());
     return false;
@@ -131,6 +164,11 @@ bool TechnosoftIpos::setRemoteVariableRaw(std::string key, const yarp::os::Bottl
 
         return true;
     }
+    else if (key == "sdo" || key == "clock")
+    {
+        CD_ERROR("Read-only key: \"%s\" (canId: %d).\n", key.c_str(), can->getId());
+        return false;
+    }
 
     CD_ERROR("Unsupported key: \"%s\".\n", key.c_str());
     return false;
@@ -147,6 +185,8 @@ bool TechnosoftIpos::getRemoteVariablesListRaw(yarp::os::Bottle * listOfKeys)
     // Place each key in its own list so that clients can just call check('<key>') or !find('<key>').isNull().
     listOfKeys->addString("linInterp");
     listOfKeys->addString("csv");
+    listOfKeys->addString("sdo");
+    listOfKeys->addString("clock");
 
     return true;
 }
@@ -71,11 +71,10 @@ bool TechnosoftIpos::getTorqueRangeRaw(int j, double * min, double * max)
     CD_DEBUG("(%d)\n", j);
     CHECK_JOINT(j);
 
-    return can->sdo()->upload<std::uint16_t>("Current limit", [this, min, max](auto data)
+    return can->sdoPool()->acquire()->upload(ipos::CURRENT_LIMIT, [this, min, max](auto data)
         { double temp = vars.internalUnitsToPeakCurrent(data);
           *max = vars.currentToTorque(temp);
-          *min = -(*max); },
-        0x207F);
+          *min = -(*max); });
 }
 
 // -------------------------------------------------------------------------------------
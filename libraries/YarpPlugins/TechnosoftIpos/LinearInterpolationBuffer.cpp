@@ -10,11 +10,16 @@
 
 using namespace roboticslab;
 
-LinearInterpolationBuffer::LinearInterpolationBuffer(const StateVariables & _vars, int _periodMs, int _bufferSize)
+LinearInterpolationBuffer::LinearInterpolationBuffer(const StateVariables & _vars, int _periodMs, int _bufferSize,
+        int _targetLatencyMs)
     : vars(_vars),
       periodMs(_periodMs),
       bufferSize(_bufferSize),
-      integrityCounter(0)
+      recordTimeMs(_periodMs),
+      model(_periodMs, _bufferSize, _targetLatencyMs, PT_PVT_BUFFER_LOW_SIGNAL),
+      targetLatencyMs(_targetLatencyMs),
+      lastTarget(0.0),
+      hasLastTarget(false)
 { }
 
 LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::os::Searchable & config,
@@ -23,6 +28,8 @@ LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::
     double periodMs = vars.syncPeriod * 1000.0;
     int bufferSize = config.check("bufferSize", yarp::os::Value(0), "linear interpolation mode buffer size").asInt32();
     std::string mode = config.check("mode", yarp::os::Value(""), "linear interpolation mode (pt/pvt)").asString();
+    int targetLatencyMs = config.check("targetLatencyMs", yarp::os::Value(bufferSize * periodMs),
+            "linear interpolation mode target latency (ms)").asInt32();
 
     if (periodMs != static_cast<int>(periodMs))
     {
@@ -36,6 +43,12 @@ LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::
         return nullptr;
     }
 
+    if (targetLatencyMs < 0)
+    {
+        CD_ERROR("Invalid linear interpolation mode target latency: %d (ms).\n", targetLatencyMs);
+        return nullptr;
+    }
+
     if (mode == "pt")
     {
         if (bufferSize > PT_BUFFER_MAX_SIZE - 1) // consume one additional slot to avoid annoying buffer full warnings
@@ -44,7 +57,7 @@ LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::
             return nullptr;
         }
 
-        return new PtBuffer(vars, periodMs, bufferSize, canId);
+        return new PtBuffer(vars, periodMs, bufferSize, targetLatencyMs, canId);
     }
     else if (mode == "pvt")
     {
@@ -59,7 +72,7 @@ LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::
             return nullptr;
         }
 
-        return new PvtBuffer(vars, periodMs, bufferSize, canId);
+        return new PvtBuffer(vars, periodMs, bufferSize, targetLatencyMs, canId);
     }
     else
     {
@@ -70,7 +83,8 @@ LinearInterpolationBuffer * LinearInterpolationBuffer::createBuffer(const yarp::
 
 void LinearInterpolationBuffer::resetIntegrityCounter()
 {
-    integrityCounter = 0;
+    model.reset();
+    hasLastTarget = false;
 }
 
 int LinearInterpolationBuffer::getPeriodMs() const
@@ -83,10 +97,55 @@ int LinearInterpolationBuffer::getBufferSize() const
     return bufferSize;
 }
 
-PtBuffer::PtBuffer(const StateVariables & vars, int periodMs, int bufferSize, unsigned int canId)
-    : LinearInterpolationBuffer(vars, periodMs, bufferSize)
+int LinearInterpolationBuffer::getTargetLatencyMs() const
+{
+    return targetLatencyMs;
+}
+
+int LinearInterpolationBuffer::getLeadDepth() const
+{
+    return model.getLeadDepth();
+}
+
+int LinearInterpolationBuffer::getOccupancy() const
+{
+    return model.getOccupancy();
+}
+
+int LinearInterpolationBuffer::getLatencyMs() const
+{
+    return model.getLatencyMs();
+}
+
+unsigned int LinearInterpolationBuffer::getUnderflows() const
+{
+    return model.getUnderflows();
+}
+
+unsigned int LinearInterpolationBuffer::getIntegrityErrors() const
+{
+    return model.getIntegrityErrors();
+}
+
+int LinearInterpolationBuffer::reserveRecords(double target)
+{
+    // repeating or skipping a record only lengthens or shortens a hold
+    bool stationary = hasLastTarget && target == lastTarget;
+    lastTarget = target;
+    hasLastTarget = true;
+    return model.reserveRecords(stationary, recordTimeMs);
+}
+
+void LinearInterpolationBuffer::updateStatus(std::uint16_t status, std::uint16_t previousStatus)
+{
+    model.updateStatus(status, previousStatus);
+}
+
+PtBuffer::PtBuffer(const StateVariables & vars, int periodMs, int bufferSize, int targetLatencyMs, unsigned int canId)
+    : LinearInterpolationBuffer(vars, periodMs, bufferSize, targetLatencyMs)
 {
-    CD_SUCCESS("Created PT buffer with period %d (ms) and buffer size %d (canId: %d).\n", periodMs, bufferSize, canId);
+    CD_SUCCESS("Created PT buffer with period %d (ms), buffer size %d and target latency %d (ms) (canId: %d).\n",
+            periodMs, bufferSize, targetLatencyMs, canId);
 }
 
 std::string PtBuffer::getType() const
@@ -106,21 +165,22 @@ std::uint64_t PtBuffer::makeDataRecord(double target)
     std::int32_t position = vars.degreesToInternalUnits(target);
     data += position;
 
-    std::int16_t time = periodMs;
+    std::int16_t time = recordTimeMs;
     data += (std::uint64_t)time << 32;
 
-    std::uint8_t ic = integrityCounter++ << 1;
+    std::uint8_t ic = model.nextIntegrityCounter() << 1;
     data += (std::uint64_t)ic << 56;
 
     return data;
 }
 
-PvtBuffer::PvtBuffer(const StateVariables & vars, int periodMs, int bufferSize, unsigned int canId)
-    : LinearInterpolationBuffer(vars, periodMs, bufferSize),
+PvtBuffer::PvtBuffer(const StateVariables & vars, int periodMs, int bufferSize, int targetLatencyMs, unsigned int canId)
+    : LinearInterpolationBuffer(vars, periodMs, bufferSize, targetLatencyMs),
       previousTarget(0.0),
       isFirstPoint(true)
 {
-    CD_SUCCESS("Created PVT buffer with period %d (ms) and buffer size %d (canId: %d).\n", periodMs, bufferSize, canId);
+    CD_SUCCESS("Created PVT buffer with period %d (ms), buffer size %d and target latency %d (ms) (canId: %d).\n",
+            periodMs, bufferSize, targetLatencyMs, canId);
 }
 
 std::string PvtBuffer::getType() const
@@ -135,7 +195,8 @@ std::int16_t PvtBuffer::getSubMode() const
 
 std::uint64_t PvtBuffer::makeDataRecord(double target)
 {
-    double v = !isFirstPoint ? (target - previousTarget) / (2 * periodMs * 0.001) : 0.0;
+    // the time field of this record may have been stretched or shrunk, see reserveRecords()
+    double v = !isFirstPoint ? (target - previousTarget) / (2 * recordTimeMs * 0.001) : 0.0;
     std::uint64_t data = 0;
 
     std::int32_t position = vars.degreesToInternalUnits(target);
@@ -149,8 +210,8 @@ std::uint64_t PvtBuffer::makeDataRecord(double target)
     CanUtils::encodeFixedPoint(velocity, &velocityInt, &velocityFrac);
     data += ((std::uint64_t)velocityInt << 32) + ((std::uint64_t)velocityFrac << 16);
 
-    std::int16_t time = (std::int16_t)(periodMs << 7) >> 7;
-    std::uint8_t ic = (integrityCounter++) << 1;
+    std::int16_t time = (std::int16_t)(recordTimeMs << 7) >> 7;
+    std::uint8_t ic = model.nextIntegrityCounter() << 1;
     std::uint16_t timeAndIc = time + (ic << 8);
     data += (std::uint64_t)timeAndIc << 48;
 
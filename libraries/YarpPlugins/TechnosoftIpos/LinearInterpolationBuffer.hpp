@@ -9,6 +9,7 @@
 
 #include <yarp/os/Searchable.h>
 
+#include "InterpolationBufferModel.hpp"
 #include "StateVariables.hpp"
 
 // https://github.com/roboticslab-uc3m/yarp-devices/issues/198#issuecomment-487279910
@@ -25,17 +26,21 @@ namespace roboticslab
  *
  * It is designed so that the current motor position can be continuously
  * commanded by a periodic thread governing this class.
+ *
+ * Buffer occupancy is modelled on the host, see @ref InterpolationBufferModel.
+ * One record is sent per SYNC, its time field stretched or shrunk in order to
+ * steer the lead; records are only added or dropped while the target holds still.
  */
 class LinearInterpolationBuffer
 {
 public:
     //! Constructor, set internal invariable parameters.
-    LinearInterpolationBuffer(const StateVariables & vars, int periodMs, int bufferSize);
+    LinearInterpolationBuffer(const StateVariables & vars, int periodMs, int bufferSize, int targetLatencyMs);
 
     //! Virtual destructor.
     virtual ~LinearInterpolationBuffer() = default;
 
-    //! Set integrity counter to zero.
+    //! Set integrity counter to zero and clear occupancy model.
     void resetIntegrityCounter();
 
     //! Get buffer type as string identifier (pt/pvt).
@@ -47,6 +52,30 @@ public:
     //! Get PT/PVT buffer size.
     int getBufferSize() const;
 
+    //! Get desired delay between setpoint and playback (milliseconds).
+    int getTargetLatencyMs() const;
+
+    //! Get current number of records meant to be queued ahead of playback.
+    int getLeadDepth() const;
+
+    //! Get estimated number of records queued in the drive.
+    int getOccupancy() const;
+
+    //! Get estimated delay between setpoint and playback (milliseconds).
+    int getLatencyMs() const;
+
+    //! Get number of buffer empty conditions since last reset.
+    unsigned int getUnderflows() const;
+
+    //! Get number of integrity counter errors since last reset.
+    unsigned int getIntegrityErrors() const;
+
+    //! Advance occupancy model by one period, return how many records shall be sent now for this target.
+    int reserveRecords(double target);
+
+    //! Correct occupancy model given the PT/PVT status reported by the drive (object 2072h).
+    void updateStatus(std::uint16_t status, std::uint16_t previousStatus);
+
     //! Generate interpolation submode register value (object 60C0h).
     virtual std::int16_t getSubMode() const = 0;
 
@@ -61,7 +90,13 @@ protected:
     const StateVariables & vars;
     int periodMs;
     int bufferSize;
-    int integrityCounter;
+    int recordTimeMs; // time field of the records reserved last
+    InterpolationBufferModel model;
+
+private:
+    int targetLatencyMs;
+    double lastTarget;
+    bool hasLastTarget;
 };
 
 /**
@@ -72,7 +107,7 @@ class PtBuffer : public LinearInterpolationBuffer
 {
 public:
     //! Constructor.
-    PtBuffer(const StateVariables & vars, int periodMs, int bufferSize, unsigned int canId);
+    PtBuffer(const StateVariables & vars, int periodMs, int bufferSize, int targetLatencyMs, unsigned int canId);
 
     virtual std::string getType() const override;
     virtual std::int16_t getSubMode() const override;
@@ -90,7 +125,7 @@ class PvtBuffer : public LinearInterpolationBuffer
 {
 public:
     //! Constructor.
-    PvtBuffer(const StateVariables & vars, int periodMs, int bufferSize, unsigned int canId);
+    PvtBuffer(const StateVariables & vars, int periodMs, int bufferSize, int targetLatencyMs, unsigned int canId);
 
     virtual std::string getType() const override;
     virtual std::int16_t getSubMode() const override;
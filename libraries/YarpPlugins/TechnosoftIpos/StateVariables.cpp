@@ -260,10 +260,13 @@ void StateVariables::reset()
 
     lastEncoderRead.reset();
     lastCurrentRead = 0.0;
+    driveClock.reset();
 
     requestedcontrolMode = 0;
     synchronousCommandTarget = prevSyncTarget = 0.0;
     enableSync = false;
+    setpointHandshake.reset();
+    startPending = false;
 }
 
 // -----------------------------------------------------------------------------
@@ -14,7 +14,9 @@
 #include <yarp/conf/numeric.h>
 #include <yarp/os/Stamp.h>
 
+#include "ClockEstimator.hpp"
 #include "PdoProtocol.hpp"
+#include "SetpointHandshake.hpp"
 #include "StateObserver.hpp"
 
 namespace roboticslab
@@ -117,6 +119,10 @@ struct StateVariables
 
     EncoderRead lastEncoderRead;
     std::atomic<std::int16_t> lastCurrentRead {0};
+    std::atomic<double> lastVelocityRead {0.0};
+    std::atomic<bool> velocityFeedback {false};
+
+    ClockEstimator driveClock {64, 4294.967296}; // 32-bit counter of microseconds
 
     std::atomic<yarp::conf::vocab32_t> actualControlMode {0};
     std::atomic<yarp::conf::vocab32_t> requestedcontrolMode {0};
@@ -131,13 +137,16 @@ struct StateVariables
     std::atomic<double> refSpeed {0.0};
     std::atomic<double> refAcceleration {0.0};
 
-    std::atomic<double> lastHeartbeat {0.0};
     std::atomic<std::uint8_t> lastNmtState {0};
 
     std::atomic<double> synchronousCommandTarget {0.0};
     std::atomic<double> prevSyncTarget {0.0};
 
     std::atomic<bool> enableSync {false};
+    SetpointHandshake setpointHandshake {0.1}; // seconds, drives usually acknowledge within a few milliseconds
+    std::atomic<bool> startPending {false};
+    std::atomic<std::int32_t> stagedTarget {0};
+    std::atomic<bool> stagedRelative {false};
     std::atomic<bool> enableCsv {false};
 
     // read only, conceptually immutable
@@ -152,13 +161,30 @@ struct StateVariables
 
     bool reverse {false};
 
+    PdoConfiguration rpdo2Conf;
     PdoConfiguration tpdo1Conf;
     PdoConfiguration tpdo2Conf;
     PdoConfiguration tpdo3Conf;
+    PdoConfiguration tpdo4Conf;
 
     double heartbeatPeriod {0.0};
     double syncPeriod {0.0};
 
+    bool nmtBroadcast {false};
+    bool driveTimestamps {false};
+    bool pdoProfiles {false};
+    bool nativeCyclic {false};
+    bool positionRpdo {false};
+    bool coordinatedStart {false};
+    bool fastModeSwitch {false};
+
+    // arbitration classes, see getCyclicFrames()
+    int rpdo3Priority {0};
+    int tpdo1Priority {1};
+    int tpdo2Priority {2};
+    int tpdo3Priority {0};
+    int tpdo4Priority {1};
+
     unsigned int canId = 0;
 };
 
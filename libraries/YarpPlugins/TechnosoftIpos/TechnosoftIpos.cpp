@@ -12,6 +12,8 @@
 
 #include <ColorDebug.h>
 
+#include "CanUtils.hpp"
+
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
@@ -289,18 +291,33 @@ void TechnosoftIpos::interpretStatusword(std::uint16_t statusword)
     switch (vars.modesOfOperation)
     {
     case 1:
-        if (reportBitToggle(report, INFO, 12, "Trajectory generator will not accept a new set-point.",
-            "Trajectory generator will accept a new set-point.")
-            && !can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4)))
+        reportBitToggle(report, INFO, 12, "Trajectory generator will not accept a new set-point.",
+            "Trajectory generator will accept a new set-point.");
+
+        // the drive resets bit 12 after bit 4 is cleared, only the rising edge acknowledges a set-point
+        if (vars.setpointHandshake.update(report.stored[12], report.actual[12]))
         {
-            CD_WARNING("Unable to finalize single set-point handshake (canId: %d).\n", can->getId());
+            if (startSkewMeter)
+            {
+                startSkewMeter->acknowledge(can->getId());
+            }
+
+            if (!can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4)))
+            {
+                CD_WARNING("Unable to finalize single set-point handshake (canId: %d).\n", can->getId());
+            }
         }
+
         reportBitToggle(report, WARN, 13, "Following error.", "No following error.");
         break;
     case 3:
         //reportBitToggle(report, INFO, 12, "Speed is equal to 0.", "Speed is not equal to 0."); // too verbose
         reportBitToggle(report, WARN, 13, "Maximum slippage reached.", "Maximum slippage not reached.");
         break;
+    case 6:
+        reportBitToggle(report, INFO, 12, "Homing attained.", "Homing not attained.");
+        reportBitToggle(report, WARN, 13, "Homing error.", "No homing error.");
+        break;
     case 7:
         reportBitToggle(report, INFO, 12, "Interpolated position mode active.", "Interpolated position mode inactive.");
         // 13: reserved
@@ -333,6 +350,7 @@ void TechnosoftIpos::interpretModesOfOperation(std::int8_t modesOfOperation)
     case 1:
         CD_INFO("Profile Position Mode. canId: %d.\n", can->getId());
         vars.actualControlMode = VOCAB_CM_POSITION;
+        vars.enableSync = vars.coordinatedStart; // staged setpoints, see synchronize()
         break;
     case 3:
         CD_INFO("Profile Velocity Mode. canId: %d.\n", can->getId());
@@ -349,6 +367,16 @@ void TechnosoftIpos::interpretModesOfOperation(std::int8_t modesOfOperation)
         vars.actualControlMode = vars.enableCsv ? VOCAB_CM_VELOCITY : VOCAB_CM_POSITION_DIRECT;
         vars.enableSync = true;
         break;
+    case 9:
+        CD_INFO("Cyclic Synchronous Velocity Mode. canId: %d.\n", can->getId());
+        vars.actualControlMode = VOCAB_CM_VELOCITY;
+        vars.enableSync = true;
+        break;
+    case 10:
+        CD_INFO("Cyclic Synchronous Torque Mode. canId: %d.\n", can->getId());
+        vars.actualControlMode = vars.requestedcontrolMode == VOCAB_CM_TORQUE ? VOCAB_CM_TORQUE : VOCAB_CM_CURRENT;
+        vars.enableSync = true;
+        break;
     // unhandled
     case -4:
         CD_INFO("iPOS specific: External Reference Speed Mode. canId: %d.\n", can->getId());
@@ -368,7 +396,7 @@ void TechnosoftIpos::interpretModesOfOperation(std::int8_t modesOfOperation)
         break;
     case 6:
         CD_INFO("Homing Mode. canId: %d.\n", can->getId());
-        vars.actualControlMode = VOCAB_CM_UNKNOWN;
+        vars.actualControlMode = VOCAB_CM_CALIBRATING;
         break;
     default:
         CD_WARNING("No mode set. canId: %d.\n", can->getId());
@@ -395,6 +423,11 @@ void TechnosoftIpos::interpretPtStatus(std::uint16_t status)
     reportBitToggle(report, INFO, 14, "Buffer is low.", "Buffer is not low.");
     reportBitToggle(report, INFO, 15, "Buffer is empty.", "Buffer is not empty.");
 
+    if (linInterpBuffer)
+    {
+        linInterpBuffer->updateStatus(status, vars.ptStatus.to_ulong());
+    }
+
     vars.ptStatus = status;
 }
 
@@ -425,6 +458,30 @@ void TechnosoftIpos::handleTpdo3(std::int32_t position, std::int16_t current)
 
 // -----------------------------------------------------------------------------
 
+void TechnosoftIpos::handleTpdo3Position(std::int32_t position)
+{
+    vars.lastEncoderRead.update(position);
+}
+
+// -----------------------------------------------------------------------------
+
+void TechnosoftIpos::handleTpdo3Velocity(std::int32_t position, std::int32_t velocity)
+{
+    vars.lastEncoderRead.update(position);
+    double value = CanUtils::decodeFixedPoint(static_cast<std::int16_t>(velocity >> 16), static_cast<std::uint16_t>(velocity & 0xFFFF));
+    vars.lastVelocityRead = vars.internalUnitsToDegrees(value, 1);
+    vars.velocityFeedback = true;
+}
+
+// -----------------------------------------------------------------------------
+
+void TechnosoftIpos::handleTpdo4(std::uint32_t timestamp)
+{
+    vars.driveClock.addSample(yarp::os::Time::now(), timestamp * 1e-6);
+}
+
+// -----------------------------------------------------------------------------
+
 void TechnosoftIpos::handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef)
 {
     switch (code.first)
@@ -465,7 +522,6 @@ void TechnosoftIpos::handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, con
 
 void TechnosoftIpos::handleNmt(NmtState state)
 {
-    vars.lastHeartbeat = yarp::os::Time::now();
     std::uint8_t nmtState = static_cast<std::uint8_t>(state);
 
     // always report boot-up
@@ -501,30 +557,3 @@ void TechnosoftIpos::handleNmt(NmtState state)
 }
 
 // -----------------------------------------------------------------------------
-
-bool TechnosoftIpos::monitorWorker(const yarp::os::YarpTimerEvent & event)
-{
-    bool isConfigured = vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED;
-    double elapsed = event.currentReal - vars.lastHeartbeat;
-
-    if (isConfigured && elapsed > event.lastDuration)
-    {
-        CD_ERROR("Last heartbeat response was %f seconds ago (canId %d).\n", elapsed, can->getId());
-        vars.actualControlMode = VOCAB_CM_NOT_CONFIGURED;
-        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
-        can->driveStatus()->reset();
-        vars.reset();
-    }
-    else if (!isConfigured && elapsed < event.lastDuration && vars.lastNmtState == 0) // boot-up event
-    {
-        if (!initialize())
-        {
-            CD_ERROR("Unable to initialize CAN comms (canId: %d).\n", can->getId());
-            can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
-        }
-    }
-
-    return true;
-}
-
-// -----------------------------------------------------------------------------
@@ -3,10 +3,9 @@
 #ifndef __TECHNOSOFT_IPOS_HPP__
 #define __TECHNOSOFT_IPOS_HPP__
 
-#include <yarp/os/Timer.h>
-
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/IAxisInfo.h>
+#include <yarp/dev/IControlCalibration.h>
 #include <yarp/dev/IControlLimits.h>
 #include <yarp/dev/IControlMode.h>
 #include <yarp/dev/ICurrentControl.h>
@@ -21,9 +20,13 @@
 #include <yarp/dev/PolyDriver.h>
 
 #include "CanOpenNode.hpp"
+#include "DriveStatusGroup.hpp"
 #include "ICanBusSharer.hpp"
 #include "LinearInterpolationBuffer.hpp"
+#include "MpdoProtocol.hpp"
+#include "StartSkewMeter.hpp"
 #include "StateVariables.hpp"
+#include "TechnosoftIposObjects.hpp"
 
 #define CHECK_JOINT(j) do { int ax; if (getAxes(&ax), (j) != ax - 1) return false; } while (0)
 
@@ -31,6 +34,8 @@
 
 // seconds
 #define DEFAULT_SDO_TIMEOUT 0.02
+#define DEFAULT_SDO_MIN_TIMEOUT 0.005
+#define DEFAULT_SDO_MAX_TIMEOUT 0.5
 #define DEFAULT_DRIVE_STATE_TIMEOUT 2.0
 
 namespace roboticslab
@@ -58,6 +63,7 @@ public:
  */
 class TechnosoftIpos : public yarp::dev::DeviceDriver,
                        public yarp::dev::IAxisInfoRaw,
+                       public yarp::dev::IControlCalibrationRaw,
                        public yarp::dev::IControlLimitsRaw,
                        public yarp::dev::IControlModeRaw,
                        public yarp::dev::ICurrentControlRaw,
@@ -69,7 +75,8 @@ class TechnosoftIpos : public yarp::dev::DeviceDriver,
                        public yarp::dev::IRemoteVariablesRaw,
                        public yarp::dev::ITorqueControlRaw,
                        public yarp::dev::IVelocityControlRaw,
-                       public ICanBusSharer
+                       public ICanBusSharer,
+                       public IDriveStatusProvider
 {
 public:
 
@@ -78,7 +85,8 @@ public:
           iEncodersTimedRawExternal(nullptr),
           iExternalEncoderCanBusSharer(nullptr),
           linInterpBuffer(nullptr),
-          monitorThread(nullptr)
+          mpdoProducer(nullptr),
+          startSkewMeter(nullptr)
     { }
 
     ~TechnosoftIpos()
@@ -93,17 +101,35 @@ public:
 
     virtual unsigned int getId() override;
     virtual std::vector<unsigned int> getAdditionalIds() override;
+    virtual bool isCanOpenNode() override;
+    virtual std::vector<unsigned int> getSyncPdoIds() override;
+    virtual std::vector<CyclicFrame> getCyclicFrames() override;
+    virtual bool setCyclicDivisor(unsigned int cobId, unsigned int divisor) override;
+    virtual bool remapCobId(unsigned int cobId, unsigned int newCobId) override;
     virtual bool notifyMessage(const can_message & message) override;
     virtual bool initialize() override;
+    virtual bool start() override;
     virtual bool finalize() override;
+    virtual void notifyHeartbeatLost() override;
+    virtual void notifyBootUp() override;
     virtual bool registerSender(CanSenderDelegate * sender) override;
     virtual bool synchronize() override;
 
+    //  --------- IDriveStatusProvider declarations. Implementation in ICanBusSharerImpl.cpp ---------
+
+    virtual DriveStatusMachine * getDriveStatus() override;
+
     //  --------- IAxisInfoRaw declarations. Implementation in IAxisInfoRawImpl.cpp ---------
 
     virtual bool getAxisNameRaw(int axis, std::string & name) override;
     virtual bool getJointTypeRaw(int axis, yarp::dev::JointTypeEnum & type) override;
 
+    //  --------- IControlCalibrationRaw declarations. Implementation in IControlCalibrationRawImpl.cpp ---------
+
+    virtual bool calibrateAxisWithParamsRaw(int axis, unsigned int type, double p1, double p2, double p3) override;
+    virtual bool setCalibrationParametersRaw(int axis, const yarp::dev::CalibrationParameters & params) override;
+    virtual bool calibrationDoneRaw(int j) override;
+
     //  --------- IControlLimitsRaw declarations. Implementation in IControlLimitsRawImpl.cpp ---------
 
     virtual bool setLimitsRaw(int axis, double min, double max) override;
@@ -265,6 +291,16 @@ public:
 private:
 
     bool setLegacyPositionInterpolationMode();
+    bool applyPdoProfile(int mode);
+    bool configureInterpolationPeriod();
+    bool requestModeOfOperation(std::int8_t mode);
+    bool sendPositionSetpoint(std::int32_t target, bool relative);
+    bool writePositionSetpoint(std::int32_t target, bool relative);
+
+    // same object as currently mapped on RPDO3, see setControlModeRaw()
+    template<typename T>
+    bool sendSyncTarget(std::uint16_t index, T data)
+    { return mpdoProducer ? mpdoProducer->stage(can->getId(), index, 0x00, data) : can->rpdo3()->write(data); }
 
     void interpretSupportedDriveModes(std::uint32_t data);
     void interpretMsr(std::uint16_t msr);
@@ -279,11 +315,12 @@ private:
     void handleTpdo1(std::uint16_t statusword, std::uint16_t msr, std::int8_t modesOfOperation);
     void handleTpdo2(std::uint16_t mer, std::uint16_t der);
     void handleTpdo3(std::int32_t position, std::int16_t current);
+    void handleTpdo3Position(std::int32_t position);
+    void handleTpdo3Velocity(std::int32_t position, std::int32_t velocity);
+    void handleTpdo4(std::uint32_t timestamp);
     void handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef);
     void handleNmt(NmtState state);
 
-    bool monitorWorker(const yarp::os::YarpTimerEvent & event);
-
     CanOpenNode * can;
 
     yarp::dev::PolyDriver externalEncoderDevice;
@@ -294,7 +331,9 @@ private:
 
     LinearInterpolationBuffer * linInterpBuffer;
 
-    yarp::os::Timer * monitorThread;
+    MpdoProducer * mpdoProducer; // not owned, shared by all nodes of the bus
+
+    StartSkewMeter * startSkewMeter; // not owned, shared by all nodes of the controlboard
 };
 
 } // namespace roboticslab
@@ -0,0 +1,83 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __TECHNOSOFT_IPOS_OBJECTS_HPP__
+#define __TECHNOSOFT_IPOS_OBJECTS_HPP__
+
+#include <cstdint>
+
+#include <string>
+
+#include "ObjectDescriptor.hpp"
+#include "PdoProtocol.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup TechnosoftIpos
+ * @brief Catalog of CiA 301, CiA 402 and iPOS-specific dictionary objects
+ * accessed by this device via SDO, and of the layout of its TPDOs.
+ */
+namespace ipos
+{
+
+// CiA 301 communication profile
+
+constexpr ObjectDescriptor<std::uint32_t> DEVICE_TYPE{"Device type", 0x1000};
+constexpr ObjectDescriptor<std::string> MANUFACTURER_SOFTWARE_VERSION{"Manufacturer software version", 0x100A};
+constexpr ObjectDescriptor<std::uint16_t> PRODUCER_HEARTBEAT_TIME{"Producer Heartbeat Time", 0x1017};
+constexpr ObjectDescriptor<std::uint32_t> PRODUCT_CODE{"Identity Object: Product Code", 0x1018, 0x02};
+constexpr ObjectDescriptor<std::uint32_t> SERIAL_NUMBER{"Identity Object: Serial number", 0x1018, 0x04};
+
+// CiA 402 device profile
+
+constexpr ObjectDescriptor<std::int8_t> MODES_OF_OPERATION{"Modes of Operation", 0x6060};
+constexpr ObjectDescriptor<std::int32_t> TARGET_POSITION{"Target position", 0x607A};
+constexpr ObjectDescriptor<std::int32_t> MIN_POSITION_LIMIT{"Software position limit: minimal position limit", 0x607D, 0x01};
+constexpr ObjectDescriptor<std::int32_t> MAX_POSITION_LIMIT{"Software position limit: maximal position limit", 0x607D, 0x02};
+constexpr ObjectDescriptor<std::uint32_t> PROFILE_VELOCITY{"Profile velocity", 0x6081};
+constexpr ObjectDescriptor<std::uint32_t> PROFILE_ACCELERATION{"Profile acceleration", 0x6083};
+constexpr ObjectDescriptor<std::int8_t> HOMING_METHOD{"Homing method", 0x6098};
+constexpr ObjectDescriptor<std::uint32_t> HOMING_SPEED_SWITCH{"Homing speeds: speed during search for switch", 0x6099, 0x01};
+constexpr ObjectDescriptor<std::uint32_t> HOMING_SPEED_ZERO{"Homing speeds: speed during search for zero", 0x6099, 0x02};
+constexpr ObjectDescriptor<std::uint32_t> HOMING_ACCELERATION{"Homing acceleration", 0x609A};
+constexpr ObjectDescriptor<std::int16_t> INTERPOLATION_SUB_MODE_SELECT{"Interpolation sub mode select", 0x60C0};
+constexpr ObjectDescriptor<std::uint8_t> INTERPOLATION_TIME_PERIOD_VALUE{"Interpolation time period: value", 0x60C2, 0x01};
+constexpr ObjectDescriptor<std::int8_t> INTERPOLATION_TIME_PERIOD_INDEX{"Interpolation time period: index", 0x60C2, 0x02};
+constexpr ObjectDescriptor<std::uint32_t> SUPPORTED_DRIVE_MODES{"Supported drive modes", 0x6502};
+
+// Technosoft iPOS manufacturer-specific objects
+
+constexpr ObjectDescriptor<std::uint16_t> EXTERNAL_REFERENCE_TYPE{"External Reference Type", 0x201D};
+constexpr ObjectDescriptor<std::uint16_t> IP_BUFFER_LENGTH{"Interpolated position buffer length", 0x2073};
+constexpr ObjectDescriptor<std::uint16_t> IP_BUFFER_CONFIGURATION{"Interpolated position buffer configuration", 0x2074};
+constexpr ObjectDescriptor<std::int32_t> IP_INITIAL_POSITION{"Interpolated position initial position", 0x2079};
+constexpr ObjectDescriptor<std::uint16_t> CURRENT_LIMIT{"Current limit", 0x207F};
+constexpr ObjectDescriptor<std::int32_t> SET_ACTUAL_POSITION{"Set actual position", 0x2081};
+constexpr ObjectDescriptor<std::uint16_t> AUXILIARY_SETTINGS_REGISTER{"Auxiliary Settings Register", 0x208E};
+
+// TPDO mappings
+
+//! Manufacturer Status Register (1002h) and Modes of Operation Display (6061h).
+using Tpdo1Mapping = PdoMapping<PdoEntry<std::uint32_t, 0x1002>, PdoEntry<std::int8_t, 0x6061>>;
+
+//! Motion Error Register (2000h) and Detailed Error Register (2002h).
+using Tpdo2Mapping = PdoMapping<PdoEntry<std::uint16_t, 0x2000>, PdoEntry<std::uint16_t, 0x2002>>;
+
+//! Position actual internal value (6063h) and Torque actual value (6077h).
+using Tpdo3Mapping = PdoMapping<PdoEntry<std::int32_t, 0x6063>, PdoEntry<std::int16_t, 0x6077>>;
+
+//! Position actual internal value (6063h), reduced TPDO3 layout.
+using Tpdo3PositionMapping = PdoMapping<PdoEntry<std::int32_t, 0x6063>>;
+
+//! Position actual internal value (6063h) and Velocity actual value (606Ch), TPDO3 layout in CSV mode.
+using Tpdo3VelocityMapping = PdoMapping<PdoEntry<std::int32_t, 0x6063>, PdoEntry<std::int32_t, 0x606C>>;
+
+//! High resolution time stamp (1013h).
+using Tpdo4Mapping = PdoMapping<PdoEntry<std::uint32_t, 0x1013>>;
+
+} // namespace ipos
+
+} // namespace roboticslab
+
+#endif // __TECHNOSOFT_IPOS_OBJECTS_HPP__
@@ -68,6 +68,12 @@ TEST_F(CanBusSharerTest, CanUtils)
     std::uint16_t frac4 = 4444;
     double v4 = CanUtils::decodeFixedPoint(int4, frac4);
     ASSERT_NEAR(v4, -4444.06781, 1e-6);
+
+    // test CanUtils::getFrameLength(std::size_t)
+
+    ASSERT_EQ(CanUtils::getFrameLength(0), 55u);
+    ASSERT_EQ(CanUtils::getFrameLength(4), 95u);
+    ASSERT_EQ(CanUtils::getFrameLength(8), 135u);
 }
 
 } // namespace test
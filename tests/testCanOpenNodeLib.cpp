@@ -3,17 +3,38 @@
 #include <cstdint>
 #include <cstring>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <future>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "CanSenderDelegate.hpp"
+#include "ObjectDescriptor.hpp"
 #include "SdoClient.hpp"
+#include "SdoChannelPool.hpp"
 #include "PdoProtocol.hpp"
+#include "MpdoProtocol.hpp"
+#include "CobIdAllocator.hpp"
 #include "NmtProtocol.hpp"
+#include "NmtMaster.hpp"
+#include "NodeScanner.hpp"
+#include "HeartbeatConsumer.hpp"
+#include "SyncProducer.hpp"
+#include "SyncCycleMonitor.hpp"
+#include "StartSkewMeter.hpp"
+#include "SetpointHandshake.hpp"
+#include "TimeProducer.hpp"
+#include "ClockEstimator.hpp"
 #include "EmcyConsumer.hpp"
+#include "EmcyJournal.hpp"
 #include "DriveStatusMachine.hpp"
+#include "DriveStatusGroup.hpp"
+#include "InterpolationBufferModel.hpp"
 #include "CanOpenNode.hpp"
 
 #include "FutureObserverLib.hpp"
@@ -103,6 +124,67 @@ private:
     std::vector<fake_message> messages;
 };
 
+/**
+ * @ingroup testCanOpenNodeLib
+ * @brief Emulates an unconfigured LSS slave that answers fastscan requests.
+ */
+class FakeLssSlave : public CanSenderDelegate
+{
+public:
+    FakeLssSlave(NodeScanner & scanner, const NodeScanner::LssAddress & address)
+        : scanner(scanner), address(address), lssPos(0), configuring(false)
+    { }
+
+    //! Answer fastscan requests synchronously, ignore other messages.
+    virtual bool prepareMessage(const can_message & msg) override
+    {
+        if (msg.id != 0x7E5 || msg.data[0] != 0x51 || configuring)
+        {
+            return true;
+        }
+
+        std::uint32_t idNumber = msg.data[1] + (msg.data[2] << 8) + (msg.data[3] << 16) + (static_cast<std::uint32_t>(msg.data[4]) << 24);
+        std::uint8_t bitChecked = msg.data[5];
+        std::uint8_t lssSub = msg.data[6];
+        std::uint8_t lssNext = msg.data[7];
+
+        if (bitChecked == 0x80)
+        {
+            lssPos = 0;
+            return respond();
+        }
+
+        if (lssSub != lssPos || (address[lssSub] >> bitChecked) != (idNumber >> bitChecked))
+        {
+            return true;
+        }
+
+        if (bitChecked == 0)
+        {
+            configuring = lssNext < lssSub;
+            lssPos = lssNext;
+        }
+
+        return respond();
+    }
+
+    //! Whether this slave has been identified.
+    bool isConfiguring() const
+    { return configuring; }
+
+private:
+    bool respond()
+    {
+        std::uint8_t response[8] = {0x4F};
+        return scanner.notifyMessage({0x7E4, 8, response}), true;
+    }
+
+    NodeScanner & scanner;
+    NodeScanner::LssAddress address;
+    std::uint8_t lssPos;
+    bool configuring;
+};
+
 /**
  * @ingroup testCanOpenNodeLib
  * @brief Manages a FakeCanSenderDelegate and registers asynchronous operations.
@@ -204,7 +286,7 @@ TEST_F(CanBusSharerTest, SdoClientExpeditedUpload)
     ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x40, index, subindex));
     ASSERT_EQ(actual4, expected4);
 
-    // test SdoClient::upload with overrun
+    // test SdoClient::upload with overrun (response to another object is ignored)
 
     std::uint8_t actualOvr;
     response[0] = 0x4F;
@@ -256,7 +338,7 @@ TEST_F(CanBusSharerTest, SdoClientExpeditedDownload)
     ASSERT_EQ(getSender()->getLastMessage().len, 8);
     ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x23, index, subindex, request3));
 
-    // test SdoClient::download with overrun
+    // test SdoClient::download with overrun (response to another object is ignored)
 
     std::uint8_t requestOvr = 0x44;
     response[3] = 0x69; // different subindex
@@ -266,6 +348,7 @@ TEST_F(CanBusSharerTest, SdoClientExpeditedDownload)
     // test SDO abort transfer in download() operation
 
     response[0] = 0x80;
+    response[3] = subindex;
     std::uint32_t abortCode = 0x06090011; // "Sub-index does not exist"
     std::memcpy(response + 4, &abortCode, 4);
     f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
@@ -367,6 +450,136 @@ TEST_F(CanBusSharerTest, SdoClientSegmented)
     ASSERT_EQ(getSender()->getMessage(3).data, toInt64(0x0D, s.substr(14, 1)));
 }
 
+TEST_F(CanBusSharerTest, SdoClientObjectDescriptor)
+{
+    SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
+
+    const std::uint16_t index = 0x1234;
+    const std::uint8_t subindex = 0x56;
+
+    constexpr ObjectDescriptor<std::int16_t> obj("Descriptor test", index, subindex);
+    static_assert(obj.size() == 2, "Size mismatch.");
+    static_assert(obj.index == index && obj.subindex == subindex, "Index mismatch.");
+
+    std::uint8_t response[8] = {0x4B, 0x00, 0x00, subindex};
+    std::memcpy(response + 1, &index, 2);
+
+    // test SdoClient::upload(), request 2 bytes
+
+    std::int16_t actual1;
+    const std::int16_t expected = 0x4444;
+    std::memcpy(response + 4, &expected, 2);
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload(obj, &actual1));
+    ASSERT_EQ(getSender()->getLastMessage().id, sdo.getCobIdRx());
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(actual1, expected);
+
+    // test SdoClient::upload(), request 2 bytes (lambda overload)
+
+    std::int16_t actual2 = 0;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload(obj, [&](auto data) { actual2 = data; }));
+    ASSERT_EQ(actual2, expected);
+
+    // test SdoClient::download(), value is converted to the type of the descriptor
+
+    response[0] = 0x60;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(obj, 0x4444));
+    ASSERT_EQ(getSender()->getLastMessage().id, sdo.getCobIdRx());
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 0x4444));
+
+    // test SdoClient::download(), floating-point values are rounded
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(obj, 19.9999));
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 20));
+
+    // test SdoClient::download(), out-of-range floating-point values saturate
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(obj, 1e6));
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 0x7FFF));
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(obj, -1e6));
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 0x8000));
+
+    constexpr ObjectDescriptor<std::uint16_t> unsignedObj("Unsigned descriptor test", index, subindex);
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(unsignedObj, -5.0));
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 0));
+
+    // test ObjectDescriptor::size(), strings have variable length
+
+    constexpr ObjectDescriptor<std::string> str("String test", index, subindex);
+    static_assert(str.size() == 0, "Size mismatch.");
+}
+
+TEST_F(CanBusSharerTest, SdoClientAdaptiveTimeout)
+{
+    const std::uint16_t index = 0x1234;
+    const std::uint8_t subindex = 0x56;
+
+    std::uint8_t response[8] = {0x4F, 0x00, 0x00, subindex, 0x44};
+    std::memcpy(response + 1, &index, 2);
+
+    std::uint8_t data;
+
+    // test round-trip time estimation, fixed timeout
+
+    SdoClient sdo1(0x05, 0x600, 0x580, TIMEOUT, getSender());
+    ASSERT_EQ(sdo1.getMetrics().transfers, 0);
+    ASSERT_EQ(sdo1.getMetrics().srtt, 0.0);
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo1.notify(response); }});
+    ASSERT_TRUE(sdo1.upload("Upload test 1", &data, index, subindex));
+    ASSERT_EQ(sdo1.getMetrics().transfers, 1);
+    ASSERT_GT(sdo1.getMetrics().srtt, 0.0);
+    ASSERT_DOUBLE_EQ(sdo1.getMetrics().rttvar, sdo1.getMetrics().srtt / 2);
+    ASSERT_DOUBLE_EQ(sdo1.getMetrics().timeout, TIMEOUT);
+
+    ASSERT_FALSE(sdo1.upload("Upload test 2", &data, index, subindex));
+    ASSERT_EQ(sdo1.getMetrics().timeouts, 1);
+    ASSERT_EQ(sdo1.getMetrics().retries, 0);
+    ASSERT_DOUBLE_EQ(sdo1.getMetrics().timeout, TIMEOUT);
+
+    // test adaptive timeout: backoff on expiration, clamped to bounds
+
+    SdoClient sdo2(0x05, 0x600, 0x580, TIMEOUT, getSender());
+    sdo2.configureAdaptiveTimeout(TIMEOUT / 4, TIMEOUT * 3);
+
+    ASSERT_FALSE(sdo2.upload("Upload test 3", &data, index, subindex));
+    ASSERT_DOUBLE_EQ(sdo2.getMetrics().timeout, TIMEOUT * 2);
+
+    ASSERT_FALSE(sdo2.upload("Upload test 4", &data, index, subindex));
+    ASSERT_DOUBLE_EQ(sdo2.getMetrics().timeout, TIMEOUT * 3);
+
+    // test adaptive timeout: shrinks on fast responses
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS / 5, [&]{ return sdo2.notify(response); }});
+    ASSERT_TRUE(sdo2.upload("Upload test 5", &data, index, subindex));
+    ASSERT_LT(sdo2.getMetrics().timeout, TIMEOUT * 3);
+    ASSERT_GE(sdo2.getMetrics().timeout, TIMEOUT / 4);
+
+    // test retransmission of initial requests
+
+    SdoClient sdo3(0x05, 0x600, 0x580, TIMEOUT, getSender());
+    sdo3.configureRetries(1);
+    getSender()->flush();
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 4, [&]{ return sdo3.notify(response); }});
+    ASSERT_TRUE(sdo3.upload("Upload test 6", &data, index, subindex));
+    ASSERT_EQ(getSender()->getMessage(0).data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(getSender()->getMessage(1).data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(sdo3.getMetrics().timeouts, 1);
+    ASSERT_EQ(sdo3.getMetrics().retries, 1);
+    ASSERT_EQ(sdo3.getMetrics().transfers, 0); // ambiguous sample, discarded
+    ASSERT_EQ(data, 0x44);
+}
+
 TEST_F(CanBusSharerTest, SdoClientPing)
 {
     const std::uint8_t id = 0x05;
@@ -388,6 +601,67 @@ TEST_F(CanBusSharerTest, SdoClientPing)
     ASSERT_TRUE(sdo.ping());
 }
 
+TEST_F(CanBusSharerTest, PdoConfiguration)
+{
+    const double syncPeriod = 0.01;
+
+    // test PdoConfiguration::getMappedSize()
+
+    PdoConfiguration conf;
+    ASSERT_EQ(conf.getMappedSize(), 0u);
+    conf.addMapping<std::int32_t>(0x6063).addMapping<std::int16_t>(0x6077);
+    ASSERT_EQ(conf.getMappedSize(), 6u);
+
+    // test PdoConfiguration::getFramesPerSync(), event-driven
+
+    ASSERT_FALSE(conf.isSynchronousCyclic());
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 1.0);
+    conf.setEventTimer(2); // 2 ms
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 5.0);
+    conf.setInhibitTime(40); // 4 ms
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 3.0);
+
+    // test PdoConfiguration::getFramesPerSync(), synchronous and RTR
+
+    conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC);
+    ASSERT_TRUE(conf.isSynchronousCyclic());
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 1.0);
+    conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC_N<4>());
+    ASSERT_TRUE(conf.isSynchronousCyclic());
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 0.25);
+    conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_ACYCLIC);
+    ASSERT_FALSE(conf.isSynchronousCyclic());
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 1.0);
+    conf.setTransmissionType(PdoTransmissionType::RTR_SYNCHRONOUS);
+    ASSERT_FALSE(conf.isSynchronousCyclic());
+    ASSERT_EQ(conf.getFramesPerSync(syncPeriod), 0.0);
+}
+
+TEST_F(CanBusSharerTest, CobIdAllocator)
+{
+    CobIdAllocator allocator;
+
+    // node 1: status TPDO1 and error TPDO2; node 2: position TPDO3 and setpoint RPDO3
+    allocator.request(0x181, 1);
+    allocator.request(0x281, 2);
+    allocator.request(0x382, 0);
+    allocator.request(0x402, 0);
+
+    ASSERT_TRUE(allocator.allocate());
+
+    ASSERT_EQ(allocator.getCobId(0x382), 0x181);
+    ASSERT_EQ(allocator.getCobId(0x402), 0x281);
+    ASSERT_EQ(allocator.getCobId(0x181), 0x382);
+    ASSERT_EQ(allocator.getCobId(0x281), 0x402);
+
+    // not requested, left untouched
+    ASSERT_EQ(allocator.getCobId(0x201), 0x201);
+
+    // test duplicate request
+    allocator.request(0x181, 0);
+    ASSERT_FALSE(allocator.allocate());
+}
+
 TEST_F(CanBusSharerTest, ReceivePdo)
 {
     SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
@@ -480,6 +754,54 @@ TEST_F(CanBusSharerTest, ReceivePdo)
     ASSERT_EQ(getSender()->getLastMessage().len, 6);
     ASSERT_EQ(getSender()->getLastMessage().data, 0x987654321234);
 
+    getSender()->flush();
+
+    // test ReceivePdo::remap(), no transfers if the mapping is already in place
+
+    ASSERT_TRUE(rpdo1.remap(PdoConfiguration().addMapping<std::int16_t>(mapping1, mapping1sub).addMapping<std::int32_t>(mapping2)));
+    ASSERT_THROW(getSender()->getMessage(0), std::out_of_range);
+
+    // test ReceivePdo::remap(), only the mapping is rewritten between destroy and recreate steps
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(responseDownload1); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return sdo.notify(responseDownload5); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 3, [&]{ return sdo.notify(responseDownload6); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 4, [&]{ return sdo.notify(responseDownload8); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 5, [&]{ return sdo.notify(responseDownload9); }});
+
+    ASSERT_TRUE(rpdo1.remap(PdoConfiguration().addMapping<std::int32_t>(mapping2)));
+
+    ASSERT_EQ(getSender()->getMessage(0).data, toInt64(0x23, comm, 0x01, cobId + (1 << 31)));
+    ASSERT_EQ(getSender()->getMessage(1).data, toInt64(0x2F, mapper, 0x00, 0));
+    ASSERT_EQ(getSender()->getMessage(2).data, toInt64(0x23, mapper, 0x01, (mapping2 << 16) + 32));
+    ASSERT_EQ(getSender()->getMessage(3).data, toInt64(0x2F, mapper, 0x00, 1));
+    ASSERT_EQ(getSender()->getMessage(4).data, toInt64(0x23, comm, 0x01, cobId));
+
+    getSender()->flush();
+
+    // test ReceivePdo::configure() with a reassigned COB-ID, changed while the PDO does not exist
+
+    const std::uint16_t customCobId = 0x181;
+    rpdo1.setCobId(customCobId);
+    ASSERT_EQ(rpdo1.getCobId(), customCobId);
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(responseUpload); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return sdo.notify(responseDownload1); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 3, [&]{ return sdo.notify(responseDownload1); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 4, [&]{ return sdo.notify(responseDownload9); }});
+
+    ASSERT_TRUE(rpdo1.configure(PdoConfiguration()));
+
+    ASSERT_EQ(getSender()->getMessage(1).data, toInt64(0x23, comm, 0x01, cobId + (1 << 31)));
+    ASSERT_EQ(getSender()->getMessage(2).data, toInt64(0x23, comm, 0x01, customCobId + (1 << 31)));
+    ASSERT_EQ(getSender()->getMessage(3).data, toInt64(0x23, comm, 0x01, customCobId));
+
+    ASSERT_TRUE((rpdo1.write<std::int32_t>(0x12345678)));
+    ASSERT_EQ(getSender()->getLastMessage().id, customCobId);
+
+    rpdo1.setCobId(0);
+    ASSERT_EQ(rpdo1.getCobId(), cobId);
+
     // test unsupported property in ReceivePdo::configure()
 
     rpdo1Conf.setRtr(true);
@@ -487,6 +809,25 @@ TEST_F(CanBusSharerTest, ReceivePdo)
     ASSERT_FALSE(rpdo1.configure(rpdo1Conf));
 }
 
+/**
+ * @ingroup testCanOpenNodeLib
+ * @brief Target of TPDO handlers bound at compile time.
+ */
+struct tpdo_target
+{
+    void handle(std::uint8_t v1, std::int16_t v2, std::uint32_t v3)
+    { actual1 = v1; actual2 = v2; actual3 = v3; }
+
+    void handleWords(std::uint16_t v1, std::uint16_t v2, std::int8_t v3)
+    { word1 = v1; word2 = v2; actual1 = v3; }
+
+    std::uint8_t actual1 {0};
+    std::int16_t actual2 {0};
+    std::uint32_t actual3 {0};
+    std::uint16_t word1 {0};
+    std::uint16_t word2 {0};
+};
+
 TEST_F(CanBusSharerTest, TransmitPdo)
 {
     SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
@@ -608,6 +949,195 @@ TEST_F(CanBusSharerTest, TransmitPdo)
 
     tpdo1.unregisterHandler();
     ASSERT_FALSE(tpdo1.accept(nullptr, 0));
+
+    // test PdoMapping::accepts()
+
+    using layout1 = PdoMapping<PdoEntry<std::uint8_t, 0x2000>, PdoEntry<std::int16_t, 0x2001>, PdoEntry<std::uint32_t, 0x2002>>;
+    using layout2 = PdoMapping<PdoEntry<std::uint32_t, 0x1002>, PdoEntry<std::int8_t, 0x6061>>;
+
+    static_assert(layout1::size() == 7, "");
+    static_assert(layout1::accepts<std::uint8_t, std::int16_t, std::uint32_t>(), "");
+    static_assert(!layout1::accepts<std::uint8_t, std::int16_t>(), "");
+    static_assert(!layout1::accepts<std::int16_t, std::uint8_t, std::uint32_t>(), "");
+    static_assert(layout2::accepts<std::uint16_t, std::uint16_t, std::int8_t>(), "");
+    static_assert(!layout2::accepts<std::uint8_t, std::uint32_t, std::int8_t>(), "");
+
+    // test PdoConfiguration::addMappings(), same SDO sequence as PdoConfiguration::addMapping()
+
+    PdoConfiguration tpdo1Mappings;
+    tpdo1Mappings.addMappings<layout1>();
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(responseUpload); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return sdo.notify(responseDownload1); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 3, [&]{ return sdo.notify(responseDownload6); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 4, [&]{ return sdo.notify(responseDownload7); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 5, [&]{ return sdo.notify(responseDownload8); }});
+    const std::uint8_t responseDownload11[8] = {0x60, mapperLSB, mapperMSB, 0x03}; // third mapping
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 6, [&]{ return sdo.notify(responseDownload11); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 7, [&]{ return sdo.notify(responseDownload9); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 8, [&]{ return sdo.notify(responseDownload10); }});
+
+    ASSERT_TRUE(tpdo1.configure(tpdo1Mappings));
+
+    ASSERT_EQ(getSender()->getMessage(3).data, toInt64(0x23, mapper, 0x01, (0x2000 << 16) + 8));
+    ASSERT_EQ(getSender()->getMessage(4).data, toInt64(0x23, mapper, 0x02, (0x2001 << 16) + 16));
+    ASSERT_EQ(getSender()->getMessage(5).data, toInt64(0x23, mapper, 0x03, (0x2002 << 16) + 32));
+    ASSERT_EQ(getSender()->getMessage(6).data, toInt64(0x2F, mapper, 0x00, 3));
+
+    getSender()->flush();
+
+    // test TransmitPdo::bindHandler() and accept()
+
+    tpdo_target target;
+    tpdo1.bindHandler<layout1, decltype(&tpdo_target::handle), &tpdo_target::handle>(&target);
+
+    ASSERT_TRUE(tpdo1.accept(raw, 7));
+    ASSERT_FALSE(tpdo1.accept(raw, 6));
+    ASSERT_EQ(target.actual1, expected1);
+    ASSERT_EQ(target.actual2, expected2);
+    ASSERT_EQ(target.actual3, expected3);
+
+    // test TransmitPdo::bindHandler(), entry split into smaller words
+
+    tpdo1.bindHandler<layout2, decltype(&tpdo_target::handleWords), &tpdo_target::handleWords>(&target);
+
+    const std::uint8_t words[5] = {0x34, 0x12, 0x78, 0x56, 0xFF};
+    ASSERT_TRUE(tpdo1.accept(words, 5));
+    ASSERT_EQ(target.word1, 0x1234);
+    ASSERT_EQ(target.word2, 0x5678);
+    ASSERT_EQ(static_cast<std::int8_t>(target.actual1), -1);
+
+    tpdo1.unregisterHandler();
+    ASSERT_FALSE(tpdo1.accept(words, 5));
+}
+
+TEST_F(CanBusSharerTest, MpdoProtocol)
+{
+    // test MpdoMessage::serialize() and MpdoMessage::parse()
+
+    std::uint8_t raw[8];
+    MpdoMessage msg {MpdoAddressing::DESTINATION, 0x05, 0x607A, 0x00, 0x12345678};
+    msg.serialize(raw);
+
+    std::uint64_t data;
+    std::memcpy(&data, raw, 8);
+    ASSERT_EQ(data, 0x1234567800607A85);
+
+    MpdoMessage parsed;
+    ASSERT_TRUE(MpdoMessage::parse(raw, 8, parsed));
+    ASSERT_EQ(parsed.addressing, MpdoAddressing::DESTINATION);
+    ASSERT_EQ(parsed.id, 0x05);
+    ASSERT_EQ(parsed.index, 0x607A);
+    ASSERT_EQ(parsed.subindex, 0x00);
+    ASSERT_EQ(parsed.data, 0x12345678u);
+    ASSERT_FALSE(MpdoMessage::parse(raw, 4, parsed));
+
+    // test MpdoProducer::write(), single node and broadcast
+
+    const std::uint16_t cobId = 0x300;
+    MpdoProducer producer(cobId, getSender());
+    producer.addNode(0x01);
+    producer.addNode(0x02);
+    producer.addNode(0x03);
+
+    ASSERT_TRUE(producer.write<std::int32_t>(0x02, 0x60FF, 0x00, -1));
+    ASSERT_EQ(getSender()->getLastMessage().id, cobId);
+    ASSERT_EQ(getSender()->getLastMessage().len, 8);
+    ASSERT_EQ(getSender()->getLastMessage().data, 0xFFFFFFFF0060FF82);
+
+    ASSERT_TRUE(producer.write<std::int16_t>(0x00, 0x6040, 0x00, 0x000F));
+    ASSERT_EQ(getSender()->getLastMessage().data, 0x0000000F00604080);
+
+    ASSERT_EQ(producer.getFrames(), 2u);
+    ASSERT_EQ(producer.getSetpoints(), 4u);
+
+    getSender()->flush();
+
+    // test MpdoProducer::flush(), all members share a value, the last one staged prevails
+
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x01, 0x60FF, 0x00, 0));
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x02, 0x60FF, 0x00, 100));
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x03, 0x60FF, 0x00, 0));
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x02, 0x60FF, 0x00, 0));
+    ASSERT_THROW(getSender()->getMessage(0), std::out_of_range); // nothing sent yet
+
+    ASSERT_TRUE(producer.flush());
+    ASSERT_EQ(getSender()->getLastMessage().data, 0x000000000060FF80);
+    ASSERT_THROW(getSender()->getMessage(1), std::out_of_range);
+    ASSERT_EQ(producer.getFrames(), 3u);
+    ASSERT_EQ(producer.getSetpoints(), 7u);
+
+    getSender()->flush();
+
+    // test MpdoProducer::flush(), distinct values are sent one by one
+
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x01, 0x607A, 0x00, 10));
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x02, 0x607A, 0x00, 10));
+    ASSERT_TRUE(producer.stage<std::int32_t>(0x03, 0x607A, 0x00, 20));
+
+    ASSERT_TRUE(producer.flush());
+    ASSERT_EQ(getSender()->getMessage(0).data, 0x0000000A00607A81);
+    ASSERT_EQ(getSender()->getMessage(1).data, 0x0000000A00607A82);
+    ASSERT_EQ(getSender()->getMessage(2).data, 0x0000001400607A83);
+
+    getSender()->flush();
+
+    // test MpdoProducer::flush(), nothing staged
+
+    ASSERT_TRUE(producer.flush());
+    ASSERT_THROW(getSender()->getMessage(0), std::out_of_range);
+
+    // test MpdoConsumer::notifyMessage()
+
+    MpdoConsumer consumer(0x380);
+    std::uint8_t actualId = 0;
+    std::uint16_t actualIndex = 0;
+    std::uint8_t actualSubindex = 0;
+    std::uint32_t actualData = 0;
+
+    consumer.registerHandler([&](std::uint8_t id, std::uint16_t index, std::uint8_t subindex, std::uint32_t data)
+        { actualId = id; actualIndex = index; actualSubindex = subindex; actualData = data; });
+
+    MpdoMessage sam {MpdoAddressing::SOURCE, 0x04, 0x6064, 0x02, 0xABCD};
+    sam.serialize(raw);
+
+    ASSERT_FALSE(consumer.notifyMessage({0x381, 8, raw}));
+    ASSERT_TRUE(consumer.notifyMessage({0x380, 8, raw}));
+    ASSERT_EQ(actualId, 0x04);
+    ASSERT_EQ(actualIndex, 0x6064);
+    ASSERT_EQ(actualSubindex, 0x02);
+    ASSERT_EQ(actualData, 0xABCDu);
+
+    msg.serialize(raw); // DAM
+    ASSERT_FALSE(consumer.notifyMessage({0x380, 8, raw}));
+
+    // test PdoConfiguration::setMultiplexed(), DAM consumer on the drive side
+
+    SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
+    ReceivePdo rpdo4(0x05, 0x500, 4, &sdo, getSender());
+    rpdo4.setCobId(cobId);
+
+    PdoConfiguration rpdo4Conf;
+    rpdo4Conf.setMultiplexed(MpdoAddressing::DESTINATION);
+    ASSERT_EQ(rpdo4Conf.getMappedSize(), 8u);
+
+    const std::uint8_t responseUpload[8] = {0x43, 0x03, 0x14, 0x01, 0x05, 0x05};
+    const std::uint8_t responseComm[8] = {0x60, 0x03, 0x14, 0x01};
+    const std::uint8_t responseMapping[8] = {0x60, 0x03, 0x16, 0x00};
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(responseUpload); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return sdo.notify(responseComm); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 3, [&]{ return sdo.notify(responseComm); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 4, [&]{ return sdo.notify(responseMapping); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 5, [&]{ return sdo.notify(responseMapping); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 6, [&]{ return sdo.notify(responseComm); }});
+
+    ASSERT_TRUE(rpdo4.configure(rpdo4Conf));
+
+    ASSERT_EQ(getSender()->getMessage(2).data, toInt64(0x23, 0x1403, 0x01, cobId + (1 << 31)));
+    ASSERT_EQ(getSender()->getMessage(3).data, toInt64(0x2F, 0x1603, 0x00, 0));
+    ASSERT_EQ(getSender()->getMessage(4).data, toInt64(0x2F, 0x1603, 0x00, 0xFF));
+    ASSERT_EQ(getSender()->getMessage(5).data, toInt64(0x23, 0x1403, 0x01, cobId));
 }
 
 TEST_F(CanBusSharerTest, NmtProtocol)
@@ -677,6 +1207,800 @@ TEST_F(CanBusSharerTest, NmtProtocol)
     ASSERT_EQ(getSender()->getLastMessage().data, static_cast<std::uint8_t>(NmtService::START_REMOTE_NODE) + (id << 8));
 }
 
+TEST_F(CanBusSharerTest, NmtMaster)
+{
+    NmtMaster master(TIMEOUT, getSender());
+    master.addNode(0x01);
+    master.addNode(0x02);
+    master.addNode(0x03);
+    master.addNode(0x03); // ignored
+
+    ASSERT_EQ(master.getNodes(), (std::vector<std::uint8_t>{0x01, 0x02, 0x03}));
+
+    std::uint8_t bootup[] = {static_cast<std::uint8_t>(NmtState::BOOTUP)};
+    std::uint8_t preop[] = {static_cast<std::uint8_t>(NmtState::PRE_OPERATIONAL)};
+    std::uint8_t op[] = {static_cast<std::uint8_t>(NmtState::OPERATIONAL)};
+
+    // test non-heartbeat messages and unknown nodes
+
+    ASSERT_FALSE(master.notifyMessage({0x181, 1, op}));
+    ASSERT_FALSE(master.notifyMessage({0x704, 1, op}));
+
+    // test broadcast command, single frame
+
+    ASSERT_TRUE(master.issueServiceCommand(NmtService::RESET_NODE));
+    ASSERT_EQ(getSender()->getLastMessage().id, 0);
+    ASSERT_EQ(getSender()->getLastMessage().len, 2);
+    ASSERT_EQ(getSender()->getLastMessage().data, static_cast<std::uint8_t>(NmtService::RESET_NODE));
+
+    // test parallel collection of boot-up messages (out of order, pre-operational heartbeats in between)
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return master.notifyMessage({0x703, 1, bootup}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return master.notifyMessage({0x701, 1, bootup}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return master.notifyMessage({0x702, 1, bootup}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return master.notifyMessage({0x701, 1, preop}); }});
+    ASSERT_TRUE(master.awaitState(NmtState::BOOTUP));
+    ASSERT_TRUE(master.getFailures().empty());
+
+    // test parallel collection of heartbeats, one node missing
+
+    ASSERT_TRUE(master.issueServiceCommand(NmtService::START_REMOTE_NODE));
+    ASSERT_FALSE(master.awaitState(NmtState::BOOTUP)); // previous reports are discarded
+    ASSERT_EQ(getSender()->getLastMessage().data, static_cast<std::uint8_t>(NmtService::START_REMOTE_NODE));
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return master.notifyMessage({0x701, 1, op}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return master.notifyMessage({0x703, 1, op}); }});
+    ASSERT_FALSE(master.awaitState(NmtState::OPERATIONAL));
+    ASSERT_EQ(master.getFailures(), std::vector<std::uint8_t>{0x02});
+
+    // test confirmations that arrived before waiting
+
+    ASSERT_TRUE(master.notifyMessage({0x702, 1, op}));
+    ASSERT_TRUE(master.awaitState(NmtState::OPERATIONAL));
+    ASSERT_TRUE(master.getFailures().empty());
+
+    // test single node command and wait
+
+    ASSERT_TRUE(master.issueServiceCommand(NmtService::ENTER_PRE_OPERATIONAL, 0x02));
+    ASSERT_EQ(getSender()->getLastMessage().id, 0);
+    ASSERT_EQ(getSender()->getLastMessage().data, static_cast<std::uint8_t>(NmtService::ENTER_PRE_OPERATIONAL) + (0x02 << 8));
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return master.notifyMessage({0x702, 1, preop}); }});
+    ASSERT_TRUE(master.awaitState(NmtState::PRE_OPERATIONAL, 0x02));
+    ASSERT_TRUE(master.awaitState(NmtState::OPERATIONAL, 0x01)); // not affected
+    ASSERT_FALSE(master.awaitState(NmtState::OPERATIONAL, 0x02));
+
+    // test unknown node
+
+    ASSERT_FALSE(master.issueServiceCommand(NmtService::RESET_NODE, 0x04));
+    ASSERT_FALSE(master.awaitState(NmtState::BOOTUP, 0x04));
+    ASSERT_EQ(master.getFailures(), std::vector<std::uint8_t>{0x04});
+}
+
+TEST_F(CanBusSharerTest, NodeScanner)
+{
+    NodeScanner scanner(TIMEOUT, getSender());
+    scanner.addNode(0x01);
+    scanner.addNode(0x02);
+    scanner.addNode(0x03);
+
+    std::uint8_t sdo[8] = {0x43, 0x00, 0x10, 0x00, 0x92, 0x01, 0x02, 0x00};
+    std::uint8_t bootup[] = {0x00};
+    std::uint8_t preop[] = {0x7F};
+
+    // test messages outside of a scan
+
+    ASSERT_FALSE(scanner.notifyMessage({0x581, 8, sdo}));
+    ASSERT_FALSE(scanner.isPresent(0x01));
+
+    // test single burst of requests, nodes confirm through SDO, boot-up and heartbeat messages
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return scanner.notifyMessage({0x582, 8, sdo}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return scanner.notifyMessage({0x701, 1, bootup}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return scanner.notifyMessage({0x703, 1, preop}); }});
+    ASSERT_TRUE(scanner.scan());
+    ASSERT_EQ(getSender()->getMessage(0).id, 0x601);
+    ASSERT_EQ(getSender()->getMessage(1).id, 0x602);
+    ASSERT_EQ(getSender()->getMessage(2).id, 0x603);
+    ASSERT_EQ(getSender()->getLastMessage().len, 8);
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x40, 0x1000, 0x00));
+    ASSERT_TRUE(scanner.isPresent(0x01));
+    ASSERT_TRUE(scanner.isPresent(0x02));
+    ASSERT_TRUE(scanner.isPresent(0x03));
+    ASSERT_TRUE(scanner.getAbsentNodes().empty());
+
+    // test missing node, a single timeout for the whole bus
+
+    getSender()->flush();
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return scanner.notifyMessage({0x581, 8, sdo}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return scanner.notifyMessage({0x583, 8, sdo}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return !scanner.notifyMessage({0x584, 8, sdo}); }});
+    ASSERT_FALSE(scanner.scan());
+    ASSERT_FALSE(scanner.isPresent(0x02));
+    ASSERT_FALSE(scanner.isPresent(0x04));
+    ASSERT_EQ(scanner.getAbsentNodes(), std::vector<std::uint8_t>{0x02});
+
+    // test LSS fastscan, no unconfigured slaves
+
+    ASSERT_TRUE(scanner.fastscan(0.001).empty());
+    ASSERT_EQ(getSender()->getLastMessage().id, 0x7E5);
+    ASSERT_EQ(getSender()->getLastMessage().data, 0x04); // switch state global: waiting
+
+    // test LSS fastscan, single unconfigured slave
+
+    const NodeScanner::LssAddress address{0x000001A3, 0x12345678, 0x00010002, 0x80000001};
+    NodeScanner lssScanner(TIMEOUT);
+    FakeLssSlave slave(lssScanner, address);
+    lssScanner.configureSender(&slave);
+
+    auto found = lssScanner.fastscan(0.001);
+    ASSERT_EQ(found.size(), 1);
+    ASSERT_EQ(found[0], address);
+    ASSERT_TRUE(slave.isConfiguring());
+}
+
+TEST_F(CanBusSharerTest, HeartbeatConsumer)
+{
+    HeartbeatConsumer consumer(TIMEOUT);
+    consumer.addNode(0x01);
+    consumer.addNode(0x02);
+    consumer.addNode(0x03);
+
+    std::vector<std::pair<std::uint8_t, double>> lost;
+    std::vector<std::uint8_t> bootUps;
+
+    consumer.registerLostHandler([&](std::uint8_t id, double elapsed) { lost.emplace_back(id, elapsed); });
+    consumer.registerBootUpHandler([&](std::uint8_t id) { bootUps.push_back(id); });
+
+    std::uint8_t bootup[] = {static_cast<std::uint8_t>(NmtState::BOOTUP)};
+    std::uint8_t op[] = {static_cast<std::uint8_t>(NmtState::OPERATIONAL)};
+
+    // test unrelated messages and unmonitored nodes
+
+    ASSERT_FALSE(consumer.notifyMessage({0x181, 1, op}));
+    ASSERT_FALSE(consumer.notifyMessage({0x704, 1, op}));
+    ASSERT_FALSE(consumer.isAlive(0x04));
+
+    // test nodes that were never seen, deadline runs from registration
+
+    consumer.check();
+    ASSERT_TRUE(consumer.isAlive(0x01));
+    ASSERT_TRUE(consumer.isAlive(0x02));
+    ASSERT_TRUE(consumer.isAlive(0x03));
+    ASSERT_TRUE(lost.empty());
+    ASSERT_TRUE(bootUps.empty());
+
+    // test boot-up events, reported once
+
+    ASSERT_TRUE(consumer.notifyMessage({0x701, 1, bootup}));
+    ASSERT_TRUE(consumer.notifyMessage({0x702, 1, op}));
+    consumer.check();
+    consumer.check();
+    ASSERT_EQ(bootUps, std::vector<std::uint8_t>{0x01});
+    ASSERT_TRUE(consumer.isAlive(0x01));
+    ASSERT_TRUE(consumer.isAlive(0x02));
+    ASSERT_TRUE(lost.empty());
+
+    // test missed deadline, only node 2 keeps sending heartbeats, node 3 never did
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(TIMEOUT / 2));
+    ASSERT_TRUE(consumer.notifyMessage({0x702, 1, op}));
+    std::this_thread::sleep_for(std::chrono::duration<double>(TIMEOUT / 2 + 0.01));
+    consumer.check();
+
+    ASSERT_FALSE(consumer.isAlive(0x01));
+    ASSERT_TRUE(consumer.isAlive(0x02));
+    ASSERT_FALSE(consumer.isAlive(0x03));
+    ASSERT_EQ(lost.size(), 2);
+    ASSERT_EQ(lost[0].first, 0x01);
+    ASSERT_TRUE(lost[0].second > TIMEOUT);
+    ASSERT_EQ(lost[1].first, 0x03);
+    ASSERT_TRUE(lost[1].second > TIMEOUT);
+
+    // test loss is reported once
+
+    consumer.check();
+    ASSERT_EQ(lost.size(), 2);
+
+    // test recovery and new loss
+
+    ASSERT_TRUE(consumer.notifyMessage({0x701, 1, bootup}));
+    consumer.check();
+    ASSERT_EQ(bootUps, (std::vector<std::uint8_t>{0x01, 0x01}));
+    ASSERT_TRUE(consumer.isAlive(0x01));
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(TIMEOUT + 0.01));
+    consumer.check();
+    ASSERT_EQ(lost.size(), 4);
+}
+
+TEST_F(CanBusSharerTest, SyncProducer)
+{
+    SyncProducer producer(getSender());
+    ASSERT_EQ(producer.getCycle(), 0);
+    ASSERT_EQ(producer.getCounter(), 0);
+
+    // test SYNC message without counter
+
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_EQ(getSender()->getLastMessage().id, 0x80);
+    ASSERT_EQ(getSender()->getLastMessage().len, 0);
+    ASSERT_EQ(producer.getCycle(), 1);
+    ASSERT_EQ(producer.getCounter(), 0);
+
+    // test illegal overflow values
+
+    ASSERT_FALSE(producer.setCounterOverflow(1));
+    ASSERT_FALSE(producer.setCounterOverflow(241));
+    ASSERT_EQ(producer.getCounterOverflow(), 0);
+
+    // test SYNC counter and wrap-around
+
+    ASSERT_TRUE(producer.setCounterOverflow(3));
+
+    for (auto expected : {2, 3, 1, 2})
+    {
+        ASSERT_TRUE(producer.sendSync());
+        ASSERT_EQ(getSender()->getLastMessage().id, 0x80);
+        ASSERT_EQ(getSender()->getLastMessage().len, 1);
+        ASSERT_EQ(getSender()->getLastMessage().data, expected);
+        ASSERT_EQ(producer.getCounter(), expected);
+    }
+
+    ASSERT_EQ(producer.getCycle(), 5);
+}
+
+TEST_F(CanBusSharerTest, SyncCycleMonitor)
+{
+    SyncProducer producer(getSender());
+    SyncCycleMonitor monitor(producer);
+    monitor.addPdo(0x01, 0x381);
+    monitor.addPdo(0x02, 0x382);
+    monitor.addPdo(0x02, 0x382);
+    monitor.addPdo(0x03, 0x284); // reassigned COB-ID
+
+    ASSERT_EQ(monitor.getNodes(), (std::vector<std::uint8_t>{0x01, 0x02, 0x03}));
+
+    std::uint8_t data[] = {0x00, 0x00};
+
+    // test untracked PDOs and messages received before the first SYNC
+
+    ASSERT_FALSE(monitor.notifyMessage({0x381, 2, data}));
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_FALSE(monitor.notifyMessage({0x181, 2, data}));
+    ASSERT_EQ(monitor.getCycle(0x181), 0);
+
+    // test regular cycles
+
+    ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data}));
+    ASSERT_TRUE(monitor.notifyMessage({0x382, 2, data}));
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data}));
+    ASSERT_TRUE(monitor.notifyMessage({0x382, 2, data}));
+
+    ASSERT_EQ(monitor.getCycle(0x381), 2);
+    ASSERT_EQ(monitor.getCycle(0x382), 2);
+    ASSERT_EQ(monitor.getMissedCycles(0x01), 0);
+    ASSERT_EQ(monitor.getDuplicatedCycles(0x01), 0);
+    ASSERT_EQ(monitor.getLateCycles(0x01), 0);
+
+    // test missed cycles, node 2 stays silent
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(producer.sendSync());
+        ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data}));
+    }
+
+    ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data}));
+    ASSERT_EQ(monitor.getCycle(0x381), 5);
+    ASSERT_EQ(monitor.getMissedCycles(0x01), 0);
+    ASSERT_EQ(monitor.getDuplicatedCycles(0x01), 1);
+
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(monitor.notifyMessage({0x382, 2, data}));
+    ASSERT_EQ(monitor.getCycle(0x382), 6);
+    ASSERT_EQ(monitor.getMissedCycles(0x02), 3);
+    ASSERT_EQ(monitor.getLateCycles(0x02), 0);
+
+    // test late PDO, node 1 misses the SYNC window and catches up in the next cycle
+
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(monitor.notifyMessage({0x382, 2, data}));
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(monitor.notifyMessage({0x382, 2, data}));
+    ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data})); // belongs to cycle 7
+    ASSERT_EQ(monitor.getMissedCycles(0x01), 2);
+    ASSERT_TRUE(monitor.notifyMessage({0x381, 2, data}));
+
+    ASSERT_EQ(monitor.getCycle(0x381), 8);
+    ASSERT_EQ(monitor.getMissedCycles(0x01), 1);
+    ASSERT_EQ(monitor.getLateCycles(0x01), 1);
+    ASSERT_EQ(monitor.getDuplicatedCycles(0x01), 1);
+    ASSERT_EQ(monitor.getMissedCycles(0x02), 3);
+    ASSERT_EQ(monitor.getDuplicatedCycles(0x02), 0);
+
+    // test reassigned COB-ID, counters belong to the registered node
+
+    ASSERT_TRUE(monitor.notifyMessage({0x284, 2, data}));
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(producer.sendSync());
+    ASSERT_TRUE(monitor.notifyMessage({0x284, 2, data}));
+
+    ASSERT_EQ(monitor.getMissedCycles(0x03), 1);
+    ASSERT_EQ(monitor.getMissedCycles(0x04), 0);
+}
+
+TEST_F(CanBusSharerTest, StartSkewMeter)
+{
+    StartSkewMeter meter;
+
+    ASSERT_EQ(meter.getStarts(), 0);
+    ASSERT_EQ(meter.getIncompleteStarts(), 0);
+    ASSERT_EQ(meter.getMeanSkew(), 0.0);
+
+    // enrollment of participants
+
+    meter.enroll(0x01);
+    meter.enroll(0x02);
+    meter.enroll(0x02); // duplicate
+    ASSERT_TRUE(meter.isEnrolled(0x01));
+    ASSERT_TRUE(meter.isEnrolled(0x02));
+    ASSERT_FALSE(meter.isEnrolled(0x03));
+
+    // single node, not measured
+
+    meter.release(0x01);
+    meter.commit();
+    meter.acknowledge(0x01);
+    ASSERT_EQ(meter.getStarts(), 0);
+
+    // acknowledgements before commit are ignored
+
+    meter.release(0x01);
+    meter.release(0x02);
+    meter.acknowledge(0x01);
+    meter.commit();
+    ASSERT_EQ(meter.getStarts(), 0);
+
+    // group of two nodes
+
+    const int millis = MILLIS; // avoid ODR-use of the static member
+    meter.acknowledge(0x02);
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+    meter.acknowledge(0x03); // not a member
+    meter.acknowledge(0x01);
+
+    ASSERT_EQ(meter.getStarts(), 1);
+    ASSERT_GE(meter.getLastSkew(), MILLIS / 1000.0);
+    ASSERT_EQ(meter.getMaxSkew(), meter.getLastSkew());
+    ASSERT_EQ(meter.getMeanSkew(), meter.getLastSkew());
+
+    // missing acknowledgement
+
+    meter.release(0x01);
+    meter.release(0x02);
+    meter.release(0x02); // duplicate
+    meter.commit();
+    meter.acknowledge(0x01);
+
+    meter.release(0x01);
+    meter.release(0x02);
+    meter.commit();
+    ASSERT_EQ(meter.getIncompleteStarts(), 1);
+
+    const double maxSkew = meter.getMaxSkew();
+    meter.acknowledge(0x01);
+    meter.acknowledge(0x02);
+
+    ASSERT_EQ(meter.getStarts(), 2);
+    ASSERT_LT(meter.getLastSkew(), maxSkew);
+    ASSERT_EQ(meter.getMaxSkew(), maxSkew);
+    ASSERT_NEAR(meter.getMeanSkew(), (maxSkew + meter.getLastSkew()) / 2, 1e-9);
+}
+
+TEST_F(CanBusSharerTest, SetpointHandshake)
+{
+    SetpointHandshake handshake(0.05);
+    ASSERT_FALSE(handshake.isPending());
+
+    // rising edge
+    handshake.registerSetpoint();
+    ASSERT_TRUE(handshake.isPending());
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_FALSE(handshake.isPending());
+
+    // no toggle
+    handshake.registerSetpoint();
+    ASSERT_FALSE(handshake.update(true, true));
+    ASSERT_TRUE(handshake.isPending());
+
+    // falling edge, bit 12 reset after bit 4 is cleared
+    ASSERT_FALSE(handshake.update(true, false));
+    ASSERT_TRUE(handshake.isPending());
+    ASSERT_FALSE(handshake.update(false, false));
+    ASSERT_TRUE(handshake.isPending());
+
+    // rising edge
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_FALSE(handshake.isPending());
+
+    // acknowledgements are matched in order
+    handshake.registerSetpoint();
+    handshake.registerSetpoint();
+    ASSERT_FALSE(handshake.update(true, false));
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_TRUE(handshake.isPending());
+    ASSERT_FALSE(handshake.update(true, false));
+    ASSERT_TRUE(handshake.isPending());
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_FALSE(handshake.isPending());
+
+    // untracked set-point (e.g. sent via SDO)
+    ASSERT_FALSE(handshake.update(true, false));
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_FALSE(handshake.isPending());
+
+    // reset
+    handshake.registerSetpoint();
+    handshake.reset();
+    ASSERT_FALSE(handshake.isPending());
+
+    // timeout
+    handshake.registerSetpoint();
+    ASSERT_TRUE(handshake.isPending());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(handshake.isPending());
+    ASSERT_FALSE(handshake.update(true, false));
+    ASSERT_TRUE(handshake.update(false, true));
+    ASSERT_FALSE(handshake.isPending());
+}
+
+TEST_F(CanBusSharerTest, InterpolationBufferModel)
+{
+    InterpolationBufferModel model(10, 20, 50, 15);
+    int timeMs;
+
+    // test status updates before streaming, ignored
+
+    model.updateStatus(0x8000, 0x0000);
+    ASSERT_EQ(model.getUnderflows(), 0);
+    ASSERT_EQ(model.getOccupancy(), 0);
+
+    // test initial prefill up to the lead depth given by the target latency
+
+    ASSERT_EQ(model.getLeadDepth(), 5);
+    ASSERT_EQ(model.reserveRecords(false, timeMs), 5);
+    ASSERT_EQ(timeMs, 10);
+    ASSERT_EQ(model.getOccupancy(), 5);
+    ASSERT_EQ(model.getLatencyMs(), 50);
+
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_EQ(model.nextIntegrityCounter(), i);
+    }
+
+    // test steady stream, one record per SYNC at the nominal period
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(model.reserveRecords(false, timeMs), 1);
+        ASSERT_EQ(timeMs, 10);
+        model.nextIntegrityCounter();
+    }
+
+    ASSERT_EQ(model.getOccupancy(), 5);
+
+    // test buffer low flag raised, last record sent (IC 7) already received
+
+    model.updateStatus(0x4000 | 7, 0x0000);
+    ASSERT_EQ(model.getOccupancy(), 15);
+
+    // test lead too deep, moving target: shrink the record by 1 ms
+
+    ASSERT_EQ(model.reserveRecords(false, timeMs), 1);
+    ASSERT_EQ(timeMs, 9);
+    ASSERT_EQ(model.getLatencyMs(), 149);
+    ASSERT_EQ(model.nextIntegrityCounter(), 8);
+
+    // test lead too deep, stationary target: drop the record
+
+    ASSERT_EQ(model.reserveRecords(true, timeMs), 0);
+    ASSERT_EQ(model.getLatencyMs(), 139);
+
+    // test buffer low flag cleared, two records still in flight
+
+    model.updateStatus(0x0000 | 6, 0x4000);
+    ASSERT_EQ(model.getOccupancy(), 18);
+
+    // test buffer empty, only records in flight remain; safety margin doubles, target latency prevails
+
+    model.updateStatus(0x8000 | 7, 0x0000);
+    ASSERT_EQ(model.getUnderflows(), 1);
+    ASSERT_EQ(model.getOccupancy(), 1);
+    ASSERT_EQ(model.getLeadDepth(), 5);
+
+    // test lead too shallow, moving target: stretch the record by 1 ms
+
+    ASSERT_EQ(model.reserveRecords(false, timeMs), 1);
+    ASSERT_EQ(timeMs, 11);
+    ASSERT_EQ(model.getLatencyMs(), 11);
+    ASSERT_EQ(model.nextIntegrityCounter(), 9);
+
+    // test lead too shallow, stationary target: hold the last target for another period
+
+    ASSERT_EQ(model.reserveRecords(true, timeMs), 2);
+    ASSERT_EQ(timeMs, 10);
+    ASSERT_EQ(model.getLatencyMs(), 21);
+    ASSERT_EQ(model.nextIntegrityCounter(), 10);
+    ASSERT_EQ(model.nextIntegrityCounter(), 11);
+
+    // test buffer full, no room left for another record
+
+    model.updateStatus(0x2000 | 11, 0x0000);
+    ASSERT_EQ(model.getOccupancy(), 21);
+    ASSERT_EQ(model.reserveRecords(false, timeMs), 0);
+
+    // test integrity counter error, the sequence restarts after the last valid record
+
+    model.updateStatus(0x3000 | 3, 0x2000);
+    ASSERT_EQ(model.getIntegrityErrors(), 1);
+    ASSERT_EQ(model.nextIntegrityCounter(), 4);
+
+    model.updateStatus(0x3000 | 4, 0x3000); // reported once
+    ASSERT_EQ(model.getIntegrityErrors(), 1);
+
+    // test reset
+
+    model.reset();
+    ASSERT_EQ(model.getOccupancy(), 0);
+    ASSERT_EQ(model.getUnderflows(), 0);
+    ASSERT_EQ(model.getIntegrityErrors(), 0);
+
+    // test 7-bit integrity counter rollover, records in flight across it
+
+    ASSERT_EQ(model.reserveRecords(false, timeMs), 5);
+
+    for (int i = 0; i < 128; i++)
+    {
+        ASSERT_EQ(model.nextIntegrityCounter(), i);
+    }
+
+    ASSERT_EQ(model.nextIntegrityCounter(), 0);
+    ASSERT_EQ(model.nextIntegrityCounter(), 1);
+
+    model.updateStatus(0x4000 | 126, 0x0000); // 127, 0 and 1 in flight
+    ASSERT_EQ(model.getOccupancy(), 18);
+
+    // test safety margin, doubles on each underflow and decays by one record per second
+
+    InterpolationBufferModel model2(10, 20, 0, 15);
+    ASSERT_EQ(model2.getLeadDepth(), 2);
+    ASSERT_EQ(model2.reserveRecords(false, timeMs), 2);
+
+    model2.updateStatus(0x8000, 0x0000);
+    ASSERT_EQ(model2.getLeadDepth(), 4);
+    model2.updateStatus(0x0000, 0x8000);
+    model2.updateStatus(0x8000, 0x0000);
+    ASSERT_EQ(model2.getLeadDepth(), 8);
+    ASSERT_EQ(model2.getUnderflows(), 2);
+
+    for (int i = 0; i < 99; i++)
+    {
+        model2.reserveRecords(false, timeMs);
+    }
+
+    ASSERT_EQ(model2.getLeadDepth(), 8);
+    model2.reserveRecords(false, timeMs);
+    ASSERT_EQ(model2.getLeadDepth(), 7);
+
+    // test closed loop against an emulated drive whose clock runs 1% faster than SYNC
+
+    InterpolationBufferModel model3(10, 20, 50, 4);
+    std::deque<int> queue; // remaining time of each record (ms)
+    std::uint16_t status = 0;
+    std::uint8_t lastIc = 0;
+    unsigned int drained = 0;
+
+    for (int cycle = 0; cycle < 3000; cycle++)
+    {
+        int records = model3.reserveRecords(false, timeMs);
+
+        for (int i = 0; i < records; i++)
+        {
+            queue.push_back(timeMs);
+            lastIc = model3.nextIntegrityCounter();
+        }
+
+        int playMs = cycle % 10 == 0 ? 11 : 10;
+
+        while (playMs > 0 && !queue.empty())
+        {
+            int step = std::min(playMs, queue.front());
+            queue.front() -= step;
+            playMs -= step;
+
+            if (queue.front() == 0)
+            {
+                queue.pop_front();
+            }
+        }
+
+        drained += playMs != 0;
+
+        std::uint16_t prevStatus = status;
+        status = lastIc;
+
+        if (queue.empty())
+        {
+            status |= 0x8000;
+        }
+
+        if (queue.size() <= 4)
+        {
+            status |= 0x4000;
+        }
+
+        model3.updateStatus(status, prevStatus);
+    }
+
+    ASSERT_EQ(drained, 0);
+    ASSERT_EQ(model3.getUnderflows(), 0);
+    ASSERT_GE(queue.size(), 2);
+    ASSERT_LE(queue.size(), 7);
+}
+
+TEST_F(CanBusSharerTest, TimeProducer)
+{
+    TimeProducer producer(getSender());
+
+    // 1984-01-02T00:00:01.5Z, one day and 1500 ms after the CANopen epoch
+    const std::chrono::system_clock::time_point time(std::chrono::milliseconds(441849601500LL));
+
+    ASSERT_TRUE(producer.sendTime(time));
+    ASSERT_EQ(getSender()->getLastMessage().id, 0x100);
+    ASSERT_EQ(getSender()->getLastMessage().len, 6);
+    ASSERT_EQ(getSender()->getLastMessage().data, 1500 + (1ULL << 32));
+
+    // 2020-01-01T12:00:00Z, 13149 days after the CANopen epoch
+
+    std::uint8_t raw[6];
+    TimeProducer::toTimeOfDay(std::chrono::system_clock::time_point(std::chrono::seconds(1577880000)), raw);
+
+    std::uint32_t ms;
+    std::uint16_t days;
+    std::memcpy(&ms, raw, 4);
+    std::memcpy(&days, raw + 4, 2);
+
+    ASSERT_EQ(ms, 43200000);
+    ASSERT_EQ(days, 13149);
+}
+
+TEST_F(CanBusSharerTest, ClockEstimator)
+{
+    ClockEstimator estimator(4);
+    ASSERT_FALSE(estimator.isReady());
+    ASSERT_EQ(estimator.getSamples(), 0);
+
+    // test single sample, pure offset
+
+    estimator.addSample(1000.0, 1.0);
+    ASSERT_FALSE(estimator.isReady());
+    ASSERT_NEAR(estimator.getOffset(), 999.0, 1e-9);
+    ASSERT_NEAR(estimator.toHostTime(2.0), 1001.0, 1e-9);
+
+    // test offset and drift of a node clock that runs 100 ppm slower than the host
+
+    for (int i = 2; i <= 6; i++)
+    {
+        estimator.addSample(1000.0 + i * (1.0 + 1e-4), i);
+    }
+
+    ASSERT_TRUE(estimator.isReady());
+    ASSERT_EQ(estimator.getSamples(), 4); // window is full
+    ASSERT_NEAR(estimator.getDrift(), 1e-4, 1e-9);
+    ASSERT_NEAR(estimator.getOffset(), 1000.0 + 6e-4, 1e-9);
+    ASSERT_NEAR(estimator.toHostTime(10.0), 1010.001, 1e-9);
+    ASSERT_NEAR(estimator.getError(), 0.0, 1e-9);
+
+    // test error bound
+
+    estimator.addSample(1000.0 + 7 * (1.0 + 1e-4) + 0.002, 7.0);
+    ASSERT_TRUE(estimator.getError() > 0.0);
+    ASSERT_TRUE(estimator.getError() < 0.002);
+
+    // test wrap-around of node timestamps
+
+    ClockEstimator wrapping(8, 10.0);
+
+    for (int i = 6; i < 14; i++)
+    {
+        wrapping.addSample(100.0 + i, i % 10);
+    }
+
+    ASSERT_NEAR(wrapping.getDrift(), 0.0, 1e-9);
+    ASSERT_NEAR(wrapping.toHostTime(3.0), 113.0, 1e-9); // last sample
+    ASSERT_NEAR(wrapping.toHostTime(9.0), 109.0, 1e-9); // previous turn
+    ASSERT_NEAR(wrapping.toHostTime(5.0), 115.0, 1e-9); // upcoming
+
+    estimator.reset();
+    ASSERT_EQ(estimator.getSamples(), 0);
+}
+
+TEST_F(CanBusSharerTest, EmcyJournal)
+{
+    EmcyJournal journal(3); // rounded up to 4
+
+    std::uint8_t overcurrent[] = {0x10, 0x23, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
+    std::uint8_t reset[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    // test unrelated messages, SYNC shares the function code of EMCY
+
+    ASSERT_FALSE(journal.notifyMessage({0x80, 0, nullptr}));
+    ASSERT_FALSE(journal.notifyMessage({0x181, 8, overcurrent}));
+    ASSERT_EQ(journal.drain([](const can_message &) {}), 0);
+
+    // test storage and counters
+
+    ASSERT_TRUE(journal.notifyMessage({0x81, 8, overcurrent}));
+    ASSERT_TRUE(journal.notifyMessage({0x82, 8, overcurrent}));
+    ASSERT_TRUE(journal.notifyMessage({0x81, 8, reset}));
+
+    ASSERT_EQ(journal.getCount(0x01), 2);
+    ASSERT_EQ(journal.getCount(0x01, 0x2310), 1);
+    ASSERT_EQ(journal.getCount(0x01, 0x0000), 1);
+    ASSERT_EQ(journal.getCount(0x02, 0x2310), 1);
+    ASSERT_EQ(journal.getCount(0x02, 0x0000), 0);
+    ASSERT_EQ(journal.getCount(0x03), 0);
+
+    std::vector<fake_message> drained;
+    ASSERT_EQ(journal.drain([&drained](const can_message & msg) { drained.emplace_back(msg); }), 3);
+    ASSERT_EQ(drained.size(), 3);
+    ASSERT_EQ(drained[0].id, 0x81);
+    ASSERT_EQ(drained[0].len, 8);
+    ASSERT_EQ(drained[0].data, 0x12310);
+    ASSERT_EQ(drained[1].id, 0x82);
+    ASSERT_EQ(drained[2].id, 0x81);
+    ASSERT_EQ(drained[2].data, 0);
+
+    // test overflow, counters keep track of dropped messages
+
+    for (int i = 0; i < 6; i++)
+    {
+        journal.notifyMessage({0x83, 8, overcurrent});
+    }
+
+    ASSERT_EQ(journal.getDropped(), 2);
+    ASSERT_EQ(journal.getCount(0x03, 0x2310), 6);
+    ASSERT_EQ(journal.drain([](const can_message &) {}), 4);
+
+    // test concurrent producer and consumer
+
+    std::atomic_bool done {false};
+
+    std::thread consumer([&]
+        {
+            while (!done)
+            {
+                journal.drain([](const can_message &) {});
+            }
+        });
+
+    unsigned int produced = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        produced += journal.notifyMessage({0x84, 8, reset});
+    }
+
+    done = true;
+    consumer.join();
+
+    ASSERT_EQ(journal.getCount(0x04), 1000);
+    ASSERT_EQ(produced + journal.getDropped(), 1002);
+}
+
 TEST_F(CanBusSharerTest, EmcyConsumer)
 {
     EmcyConsumer emcy;
@@ -832,6 +2156,15 @@ TEST_F(CanBusSharerTest, DriveStatusMachine)
     ASSERT_EQ(getSender()->getLastMessage().data, status.controlword().to_ulong());
     ASSERT_EQ(status.controlword(), 0x1234);
 
+    // test controlword commands packed along with other objects
+
+    ReceivePdo rpdo2(id, 0x300, 2, &sdo, getSender());
+    ASSERT_TRUE(status.controlword(&rpdo2, 0x0030, static_cast<std::int32_t>(0x12345678)));
+    ASSERT_EQ(getSender()->getLastMessage().id, rpdo2.getCobId());
+    ASSERT_EQ(getSender()->getLastMessage().len, 6);
+    ASSERT_EQ(getSender()->getLastMessage().data, 0x0030'1234'5678);
+    ASSERT_EQ(status.controlword(), 0x0030);
+
     // test reset
 
     status.reset();
@@ -1101,6 +2434,121 @@ TEST_F(CanBusSharerTest, DriveStatusMachine)
     ASSERT_FALSE(status.requestState(DriveState::SWITCH_ON_DISABLED));
 }
 
+TEST_F(CanBusSharerTest, DriveStatusGroup)
+{
+    const std::uint16_t switchOnDisabled = 0b0000'0000'0100'0000;
+    const std::uint16_t readyToSwitchOn = 0b0000'0000'0010'0001;
+    const std::uint16_t switchedOn = 0b0000'0000'0010'0011;
+    const std::uint16_t operationEnabled = 0b0000'0000'0010'0111;
+
+    SdoClient sdo(0x01, 0x600, 0x580, TIMEOUT, getSender());
+    ReceivePdo rpdo1(0x01, 0x200, 1, &sdo, getSender());
+    ReceivePdo rpdo2(0x02, 0x200, 1, &sdo, getSender());
+    ReceivePdo rpdo3(0x03, 0x200, 1, &sdo, getSender());
+
+    DriveStatusMachine status1(&rpdo1, TIMEOUT);
+    DriveStatusMachine status2(&rpdo2, TIMEOUT);
+    DriveStatusMachine status3(&rpdo3, TIMEOUT);
+
+    DriveStatusGroup group(TIMEOUT);
+    group.add(&status1);
+    group.add(&status2);
+    group.add(&status3);
+    ASSERT_EQ(group.size(), 3);
+
+    std::vector<DriveStatusMachine *> drives {&status1, &status2, &status3};
+    std::atomic_bool running{true};
+    std::atomic_int unresponsive{-1};
+
+    // simulate drives: translate the last controlword into a statusword
+    auto simulator = std::async(std::launch::async, [&]
+        {
+            while (running)
+            {
+                for (auto i = 0; i < static_cast<int>(drives.size()); i++)
+                {
+                    if (i == unresponsive)
+                    {
+                        continue;
+                    }
+
+                    switch (drives[i]->controlword().to_ulong() & 0x008F)
+                    {
+                    case 0x0000: drives[i]->update(switchOnDisabled); break;
+                    case 0x0006: drives[i]->update(readyToSwitchOn); break;
+                    case 0x0007: drives[i]->update(switchedOn); break;
+                    case 0x000F: drives[i]->update(operationEnabled); break;
+                    }
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(MILLIS / 10));
+            }
+        });
+
+    for (auto * drive : drives)
+    {
+        ASSERT_TRUE(drive->update(switchOnDisabled));
+    }
+
+    // test SWITCH_ON_DISABLED -> OPERATION_ENABLED (state request, three steps)
+
+    ASSERT_TRUE(group.requestState(DriveState::OPERATION_ENABLED));
+    ASSERT_TRUE(group.getFailures().empty());
+
+    for (auto * drive : drives)
+    {
+        ASSERT_EQ(drive->getCurrentState(), DriveState::OPERATION_ENABLED);
+        ASSERT_EQ(drive->controlword(), 0x000F);
+    }
+
+    // test OPERATION_ENABLED -> SWITCHED_ON (transition 5: DISABLE_OPERATION)
+
+    ASSERT_TRUE(group.requestTransition(DriveTransition::DISABLE_OPERATION));
+    ASSERT_TRUE(group.getFailures().empty());
+
+    for (auto * drive : drives)
+    {
+        ASSERT_EQ(drive->getCurrentState(), DriveState::SWITCHED_ON);
+    }
+
+    // test unsupported transition
+
+    ASSERT_FALSE(group.requestTransition(DriveTransition::FAULT_RESET));
+    ASSERT_EQ(group.getFailures().size(), 3);
+
+    // test SWITCHED_ON -> SWITCH_ON_DISABLED (state request, one step)
+
+    ASSERT_TRUE(group.requestState(DriveState::SWITCH_ON_DISABLED));
+
+    for (auto * drive : drives)
+    {
+        ASSERT_EQ(drive->getCurrentState(), DriveState::SWITCH_ON_DISABLED);
+    }
+
+    // test SWITCH_ON_DISABLED -> OPERATION_ENABLED (state request, one drive does not respond)
+
+    unresponsive = 1;
+    ASSERT_FALSE(group.requestState(DriveState::OPERATION_ENABLED));
+    ASSERT_EQ(group.getFailures(), std::vector<unsigned int>{1});
+    ASSERT_EQ(status1.getCurrentState(), DriveState::OPERATION_ENABLED);
+    ASSERT_EQ(status2.getCurrentState(), DriveState::SWITCH_ON_DISABLED);
+    ASSERT_EQ(status3.getCurrentState(), DriveState::OPERATION_ENABLED);
+
+    // test mixed initial states, each drive follows its own path
+
+    unresponsive = -1;
+    ASSERT_TRUE(group.requestState(DriveState::OPERATION_ENABLED));
+    ASSERT_TRUE(group.getFailures().empty());
+
+    for (auto * drive : drives)
+    {
+        ASSERT_EQ(drive->getCurrentState(), DriveState::OPERATION_ENABLED);
+    }
+
+    running = false;
+    simulator.wait();
+}
+
 TEST_F(CanBusSharerTest, CanOpenNode)
 {
     std::uint8_t id = 0x05;
@@ -1197,6 +2645,14 @@ TEST_F(CanBusSharerTest, CanOpenNode)
     ASSERT_TRUE(can.notifyMessage({0x480u + id, 1, raw5}));
     ASSERT_EQ(actualTpdo4, expectedTpdo4);
 
+    // test TPDO with reassigned COB-ID
+
+    can.tpdo3()->setCobId(0x181);
+    ASSERT_TRUE(can.notifyMessage({0x181, 1, raw2}));
+    ASSERT_EQ(actualTpdo3, expectedTpdo1);
+    ASSERT_FALSE(can.notifyMessage({0x380u + id, 1, raw4}));
+    can.tpdo3()->setCobId(0);
+
     // test SDO
 
     const std::uint8_t raw6[8] = {0x60, 0x34, 0x12, 0x56};
@@ -1213,5 +2669,63 @@ TEST_F(CanBusSharerTest, CanOpenNode)
     ASSERT_EQ(actualNmt, expectedNmt);
 }
 
+TEST_F(CanBusSharerTest, SdoChannelPool)
+{
+    std::uint8_t id = 0x05;
+    CanOpenNode can(id, TIMEOUT, TIMEOUT, getSender());
+
+    ASSERT_EQ(can.sdoPool()->getChannels().size(), 1);
+    ASSERT_EQ(can.sdoPool()->getChannels()[0], can.sdo());
+    ASSERT_EQ(can.sdoPool()->getEnabledCount(), 1);
+
+    // test default channel lease
+
+    {
+        auto lease = can.sdoPool()->acquire();
+        ASSERT_EQ(lease.get(), can.sdo());
+    }
+
+    // test additional channel, disabled until configured
+
+    can.addSdoChannel(0x680, 0x780);
+    ASSERT_EQ(can.sdoPool()->getChannels().size(), 2);
+    ASSERT_EQ(can.sdoPool()->getEnabledCount(), 1);
+
+    SdoClient * sdo2 = can.sdoPool()->getChannels()[1];
+    ASSERT_EQ(sdo2->getCobIdRx(), 0x680 + id);
+    ASSERT_EQ(sdo2->getCobIdTx(), 0x780 + id);
+
+    const std::uint8_t raw1[8] = {0x60, 0x01, 0x12, 0x01};
+    const std::uint8_t raw2[8] = {0x60, 0x01, 0x12, 0x02};
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return can.notifyMessage({0x580u + id, 8, raw1}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return can.notifyMessage({0x580u + id, 8, raw2}); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 3, [&]{ return can.notifyMessage({0x580u + id, 8, raw1}); }});
+    getSender()->flush();
+
+    // channel is invalidated (bit 31) before its COB-IDs are changed
+    ASSERT_TRUE(can.configureSdoChannels());
+    ASSERT_EQ(getSender()->getMessage(0).id, 0x600 + id);
+    ASSERT_EQ(getSender()->getMessage(0).data, toInt64(0x23, 0x1201, 0x01, 0x80000000 | (0x680 + id)));
+    ASSERT_EQ(getSender()->getMessage(1).id, 0x600 + id);
+    ASSERT_EQ(getSender()->getMessage(1).data, toInt64(0x23, 0x1201, 0x02, 0x780 + id));
+    ASSERT_EQ(getSender()->getMessage(2).id, 0x600 + id);
+    ASSERT_EQ(getSender()->getMessage(2).data, toInt64(0x23, 0x1201, 0x01, 0x680 + id));
+    ASSERT_EQ(can.sdoPool()->getEnabledCount(), 2);
+
+    // test concurrent leases
+
+    auto lease1 = can.sdoPool()->acquire();
+    auto lease2 = can.sdoPool()->acquire();
+    ASSERT_EQ(lease1.get(), can.sdo());
+    ASSERT_EQ(lease2.get(), sdo2);
+
+    // test transfer on additional channel
+
+    const std::uint8_t raw3[8] = {0x60, 0x34, 0x12, 0x56};
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return can.notifyMessage({0x780u + id, 8, raw3}); }});
+    ASSERT_TRUE(lease2->download("Download test", 0x00, 0x1234, 0x56));
+    ASSERT_EQ(getSender()->getLastMessage().id, 0x680 + id);
+}
+
 } // namespace test
 } // namespace roboticslab
@@ -1,6 +1,12 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "StateObserver.hpp"
 
@@ -39,6 +45,101 @@ protected:
     static constexpr double TIMEOUT = 0.125; // [s]
 };
 
+/**
+ * @ingroup testStateObserverLib
+ * @brief Replica of the former observer implementation, allocates a semaphore
+ * on each wait. Used as a reference in benchmarks.
+ */
+class LegacyStateObserver
+{
+public:
+    LegacyStateObserver(double timeout) : timeout(timeout), semaphore(nullptr)
+    { }
+
+    bool await()
+    {
+        std::lock_guard<std::mutex> awaitLock(awaitMutex);
+
+        {
+            std::lock_guard<std::mutex> registryLock(registryMutex);
+            semaphore = new Semaphore;
+        }
+
+        bool ok;
+
+        {
+            std::unique_lock<std::mutex> lock(semaphore->mutex);
+            ok = semaphore->cond.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return semaphore->posted; });
+        }
+
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        delete semaphore;
+        semaphore = nullptr;
+        return ok;
+    }
+
+    bool notify()
+    {
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+
+        if (semaphore != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(semaphore->mutex);
+            semaphore->posted = true;
+            semaphore->cond.notify_one();
+        }
+
+        return true;
+    }
+
+private:
+    struct Semaphore
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool posted = false;
+    };
+
+    double timeout;
+    Semaphore * semaphore;
+    std::mutex registryMutex;
+    std::mutex awaitMutex;
+};
+
+/**
+ * @ingroup testStateObserverLib
+ * @brief Measure mean await/notify hand-off latency (microseconds).
+ */
+template<typename Observer>
+double measureLatency(Observer & observer, int iterations)
+{
+    std::atomic_bool running(true);
+
+    std::thread notifier([&]
+        {
+            while (running)
+            {
+                observer.notify();
+                std::this_thread::yield();
+            }
+        });
+
+    int successes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++)
+    {
+        successes += observer.await();
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    running = false;
+    notifier.join();
+
+    return successes == iterations ? elapsed.count() / iterations : -1.0;
+}
+
 TEST_F(CanBusSharerTest, StateObserver)
 {
     // test StateObserver
@@ -110,5 +211,104 @@ TEST_F(CanBusSharerTest, StateObserver)
     ASSERT_TRUE(emptyStateObserver.notify());
 }
 
+TEST_F(CanBusSharerTest, StateObserverMultipleWaiters)
+{
+    TypedStateObserver<int> observer(TIMEOUT * 4);
+
+    int val1 = 0;
+    int val2 = 0;
+    int val3 = 0;
+
+    // test keyed waiters, plus one that accepts any key
+
+    auto f1 = std::async(std::launch::async, [&] { return observer.await(&val1, 1); });
+    auto f2 = std::async(std::launch::async, [&] { return observer.await(&val2, 2); });
+    auto f3 = std::async(std::launch::async, [&] { return observer.await(&val3); });
+
+    const int millis = MILLIS; // avoid ODR-use of the static member
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+    ASSERT_TRUE(observer.notify(5, 1));
+    ASSERT_TRUE(f1.get());
+    ASSERT_TRUE(f3.get());
+    ASSERT_EQ(val1, 5);
+    ASSERT_EQ(val3, 5);
+    ASSERT_EQ(val2, 0);
+
+    ASSERT_TRUE(observer.notify(7));
+    ASSERT_TRUE(f2.get());
+    ASSERT_EQ(val2, 7);
+
+    // test key mismatch
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return observer.notify(9, 3); }});
+    observer.setTimeout(TIMEOUT);
+    ASSERT_FALSE(observer.await(&val1, 4));
+    ASSERT_EQ(val1, 5);
+
+    // test more waiters than slots, the last one takes a slot after another timed out
+
+    StateObserver limited(TIMEOUT, 1);
+    auto f4 = std::async(std::launch::async, [&] { return limited.await(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(MILLIS / 5));
+    ASSERT_FALSE(limited.await());
+    ASSERT_FALSE(f4.get());
+}
+
+TEST_F(CanBusSharerTest, StateObserverCombinators)
+{
+    StateObserver observer1(TIMEOUT);
+    StateObserver observer2(TIMEOUT);
+    StateObserver observer3(TIMEOUT);
+
+    const std::vector<StateObserver *> observers {&observer1, &observer2, &observer3};
+
+    // test awaitAny
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return observer2.notify(); }});
+    ASSERT_EQ(awaitAny(observers, TIMEOUT), 1);
+
+    // test awaitAny, timeout
+
+    ASSERT_EQ(awaitAny(observers, TIMEOUT), -1);
+
+    // test awaitAny, condition already met before waiting
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(awaitAny(observers, TIMEOUT, [] { return 2; }), 2);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_LT(elapsed.count(), TIMEOUT / 2);
+
+    // test awaitAny, condition not met, wait for notification
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return observer3.notify(); }});
+    ASSERT_EQ(awaitAny(observers, TIMEOUT, [] { return -1; }), 2);
+
+    // test empty sets
+
+    ASSERT_EQ(awaitAny({}, TIMEOUT), -1);
+
+    // test regular waits after combinators
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return observer1.notify(); }});
+    ASSERT_TRUE(observer1.await());
+}
+
+TEST_F(CanBusSharerTest, StateObserverBenchmark)
+{
+    const int iterations = 10000;
+
+    StateObserver observer(TIMEOUT);
+    LegacyStateObserver legacyObserver(TIMEOUT);
+
+    double latency = measureLatency(observer, iterations);
+    double legacyLatency = measureLatency(legacyObserver, iterations);
+
+    ASSERT_GT(latency, 0.0);
+    ASSERT_GT(legacyLatency, 0.0);
+
+    RecordProperty("latency_us", std::to_string(latency));
+    RecordProperty("legacy_latency_us", std::to_string(legacyLatency));
+}
+
 } // namespace test
 } // namespace roboticslab